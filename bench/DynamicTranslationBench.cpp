@@ -0,0 +1,1567 @@
+// Replays a key stream through the translation core against mock providers and reports throughput, tail latency
+// and allocations per call. Runs anywhere the core builds, so translate-path regressions can be caught without the
+// game.
+//
+// Usage: DynamicTranslationBench [--keys FILE | --trace FILE] [--calls N] [--keys-per-frame N] [--frame-us N]
+//                                [--papyrus-delay-frames N] [--passes N] [--report] [--rules] [--index-keys N]
+//                                [--text] [--baseline] [--registry-stress N] [--config-files N]
+//                                [--registry-cache N] [--batch-keys N]
+//
+// A key file holds one GFx key per line ("$Key"); an empty line ends a frame. Without --keys a skewed synthetic
+// stream is generated. Every distinct key is assigned a provider kind from its hash, so replays are repeatable.
+//
+// --trace replays a capture taken in game (StartTranslationTraceV1): calls run in their recorded order, frames are
+// cut every --frame-us of capture time, each key is served by a mock of the provider kind it had in game, and the
+// replayed latencies are printed next to the recorded ones.
+//
+// --baseline replays the stream a second time through the lookup the hook used before the key index (transcode every
+// key, strip the '$', copy the provider out of a map under a shared lock) so both paths are measured side by side.
+// --rules also times a rule provider against a Papyrus provider answering the same keys, each in isolation.
+// --index-keys builds a registry of N synthetic keys plus prefix families and reports its heap footprint and lookup
+// latency, next to those of the plugin's original map of UTF-8 keys to Provider copies and of an exact-key UTF-16 map,
+// both holding the same keys with every family expanded.
+// --registry-stress runs N reader threads doing ReadGuard + Find while another thread keeps publishing new snapshots,
+// then the same against a map behind a std::shared_mutex, and reports lookups per second for both. Every snapshot
+// holds the same keys, so a failed lookup means a reader saw a freed snapshot; the exit code is 1 then. Build with
+// -DDTF_SANITIZE=address or =thread to have the sanitizer check the reclamation as well.
+// --config-files writes N synthetic config files to a temporary folder and times reading + parsing them and merging
+// the result, as a cold start of the plugin does; the exit code is 1 if the merged registry is not the expected one.
+// It also writes the registry cache image of the merged result and times reading it back, the warm start. Needs a
+// core built with RapidJSON.
+// --registry-cache writes the registry cache image of a synthetic pack of N keys, reads it back and times both; the
+// exit code is 1 if the read differs from what was written or a stale or truncated image is accepted.
+// --batch-keys shows N keys served by one batch DLL, as a menu would: one frame opening it, then steady frames, once
+// with "memoize" and once without, and reports the batch calls and keys per frame. The exit code is 1 if the frame
+// opening the menu takes more than two calls or a steady frame more than one (per 256 keys).
+// --text checks every UTF-8/wchar_t conversion kernel the CPU supports against a plain reference converter on random
+// and malformed input, then reports their throughput; the exit code is 1 if any output differs.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#include "Core/CircuitBreaker.h"
+#if DTF_HAS_CONFIG_PARSER
+    #include "Core/ConfigParser.h"
+#endif
+#include "Core/KeyIndex.h"
+#include "Core/LazyProvider.h"
+#include "Core/NativeBatch.h"
+#include "Core/ProviderRegistry.h"
+#include "Core/RegistryCache.h"
+#include "Core/ResultCache.h"
+#include "Core/Rules.h"
+#include "Core/Stats.h"
+#include "Core/Text.h"
+#include "Core/Trace.h"
+#include "Core/Translator.h"
+
+namespace {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocatedBytes{0};
+    std::atomic<std::int64_t> liveBytes{0};
+
+    // Every block starts with its size so frees can be subtracted from liveBytes; keeps malloc's alignment
+    constexpr std::size_t kBlockHeader = alignof(std::max_align_t);
+}
+
+void* operator new(const std::size_t a_size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(a_size, std::memory_order_relaxed);
+    if (const auto ptr = static_cast<char*>(std::malloc(a_size + kBlockHeader))) {
+        *reinterpret_cast<std::size_t*>(ptr) = a_size;
+        liveBytes.fetch_add(static_cast<std::int64_t>(a_size), std::memory_order_relaxed);
+        return ptr + kBlockHeader;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* a_ptr) noexcept {
+    if (!a_ptr) {
+        return;
+    }
+    const auto block = static_cast<char*>(a_ptr) - kBlockHeader;
+    liveBytes.fetch_sub(static_cast<std::int64_t>(*reinterpret_cast<std::size_t*>(block)), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* a_ptr, std::size_t) noexcept {
+    operator delete(a_ptr);
+}
+
+namespace {
+    using namespace DynamicTranslationSE;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string keysFile;
+        std::string traceFile;
+        std::size_t calls = 1'000'000;
+        std::size_t keysPerFrame = 64;
+        std::uint64_t frameUs = 16'667;
+        std::uint64_t papyrusDelayFrames = 2;
+        std::size_t passes = 3;
+        bool report = false;
+        bool rules = false;
+        std::size_t indexKeys = 0;
+        bool text = false;
+        bool baseline = false;
+        std::size_t stressReaders = 0;
+        std::size_t configFiles = 0;
+        std::size_t registryCacheKeys = 0;
+        std::size_t batchKeys = 0;
+    };
+
+    // A replayable stream: keys in call order, with frame boundaries before the given call indices
+    struct KeyStream {
+        std::vector<std::wstring> keys;
+        std::vector<std::size_t> frameEnds;
+        // Only for captures: per call, the provider kind that served it in game and the recorded latency
+        std::vector<ProviderKind> kinds;
+        std::vector<std::uint64_t> recordedNs;
+    };
+
+    constexpr std::array<const char*, static_cast<std::size_t>(ProviderKind::kTotal)> kKindNames{
+        "none", "native", "native memoized", "batch", "papyrus", "unregistered", "rules"};
+
+    std::wstring Widen(const std::string_view a_ascii) {
+        return {a_ascii.begin(), a_ascii.end()};
+    }
+
+    const wchar_t* __cdecl MockNative(const std::string_view a_key) {
+        thread_local std::wstring result;
+        result.assign(L"Native ");
+        result.append(a_key.begin(), a_key.end());
+        return result.c_str();
+    }
+
+    std::uint32_t __cdecl MockBatch(DTFBatchRequest* a_request) {
+        constexpr std::wstring_view kPrefix = L"Batch ";
+        for (std::uint32_t i = 0; i < a_request->count; ++i) {
+            const auto& key = a_request->keys[i];
+            const auto size = static_cast<std::uint32_t>(kPrefix.size() + key.size);
+            if (size > a_request->arenaCapacity - a_request->arenaUsed) {
+                return kDTFArenaFull;
+            }
+            auto out = a_request->arena + a_request->arenaUsed;
+            out = std::copy(kPrefix.begin(), kPrefix.end(), out);
+            std::copy(key.data, key.data + key.size, out);
+            a_request->results[i] = {a_request->arenaUsed, size, kDTFOk};
+            a_request->arenaUsed += size;
+        }
+        return kDTFOk;
+    }
+
+    // MockBatch, counting the calls and the keys they carried
+    std::atomic<std::uint64_t> batchCalls{0};
+    std::atomic<std::uint64_t> batchCallKeys{0};
+
+    std::uint32_t __cdecl CountingBatch(DTFBatchRequest* a_request) {
+        batchCalls.fetch_add(1, std::memory_order_relaxed);
+        batchCallKeys.fetch_add(a_request->count, std::memory_order_relaxed);
+        return MockBatch(a_request);
+    }
+
+    // Frames advance between stream frames; Papyrus results arrive a fixed number of frames after dispatch
+    class MockHost final : public TranslationHost {
+    public:
+        explicit MockHost(const std::uint64_t a_delayFrames) : delayFrames(a_delayFrames) {}
+
+        std::uint64_t CurrentFrame() override { return frame; }
+
+        void DispatchPapyrus(const PapyrusScriptID&, const std::string& a_key,
+                             const std::chrono::milliseconds a_ttl) override {
+            pending.push_back({a_key, a_ttl, frame + delayFrames});
+        }
+
+        // Every key of the stream is translated again each frame anyway
+        void RequestRefresh() override {}
+
+        void AdvanceFrame() {
+            FlushNativeBatches();
+            ++frame;
+            std::erase_if(pending, [this](const Pending& a_pending) {
+                if (a_pending.dueFrame > frame) {
+                    return false;
+                }
+                CompletePapyrusDispatch(a_pending.key, L"Papyrus " + Text::Utf8ToWide(a_pending.key), a_pending.ttl);
+                return true;
+            });
+        }
+
+    private:
+        struct Pending {
+            std::string key;
+            std::chrono::milliseconds ttl;
+            std::uint64_t dueFrame;
+        };
+
+        std::uint64_t delayFrames;
+        std::uint64_t frame{0};
+        std::vector<Pending> pending;
+    };
+
+    // Stands in for the vanilla GFx translator: known strings translate, everything else echoes the key
+    class MockTranslator {
+    public:
+        void Add(const std::wstring& a_key) { strings.emplace(a_key, L"Vanilla " + a_key.substr(1)); }
+
+        void Translate(const std::wstring& a_key, std::wstring& a_result) const {
+            const auto it = strings.find(a_key);
+            a_result = it != strings.end() ? it->second : a_key;
+        }
+
+    private:
+        std::unordered_map<std::wstring, std::wstring> strings;
+    };
+
+    bool ParseOptions(const int a_argc, char** a_argv, Options& a_options) {
+        for (int i = 1; i < a_argc; ++i) {
+            const std::string_view arg = a_argv[i];
+            const auto next = [&]() -> const char* { return i + 1 < a_argc ? a_argv[++i] : nullptr; };
+            const auto number = [&](auto& a_out) {
+                const auto value = next();
+                if (!value) {
+                    return false;
+                }
+                a_out = static_cast<std::remove_reference_t<decltype(a_out)>>(std::strtoull(value, nullptr, 10));
+                return true;
+            };
+
+            bool ok = true;
+            if (arg == "--keys" || arg == "--trace") {
+                const auto value = next();
+                ok = value != nullptr;
+                if (ok) {
+                    (arg == "--keys" ? a_options.keysFile : a_options.traceFile) = value;
+                }
+            } else if (arg == "--frame-us") {
+                ok = number(a_options.frameUs) && a_options.frameUs > 0;
+            } else if (arg == "--calls") {
+                ok = number(a_options.calls);
+            } else if (arg == "--keys-per-frame") {
+                ok = number(a_options.keysPerFrame) && a_options.keysPerFrame > 0;
+            } else if (arg == "--papyrus-delay-frames") {
+                ok = number(a_options.papyrusDelayFrames);
+            } else if (arg == "--passes") {
+                ok = number(a_options.passes) && a_options.passes > 0;
+            } else if (arg == "--report") {
+                a_options.report = true;
+            } else if (arg == "--rules") {
+                a_options.rules = true;
+            } else if (arg == "--index-keys") {
+                ok = number(a_options.indexKeys) && a_options.indexKeys > 0;
+            } else if (arg == "--text") {
+                a_options.text = true;
+            } else if (arg == "--baseline") {
+                a_options.baseline = true;
+            } else if (arg == "--registry-stress") {
+                ok = number(a_options.stressReaders) && a_options.stressReaders > 0;
+            } else if (arg == "--config-files") {
+                ok = number(a_options.configFiles) && a_options.configFiles > 0;
+            } else if (arg == "--registry-cache") {
+                ok = number(a_options.registryCacheKeys) && a_options.registryCacheKeys > 0;
+            } else if (arg == "--batch-keys") {
+                ok = number(a_options.batchKeys) && a_options.batchKeys > 0;
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                std::fprintf(stderr, "Invalid argument '%s'\n", a_argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LoadKeyStream(const Options& a_options, KeyStream& a_stream) {
+        std::ifstream in(a_options.keysFile);
+        if (!in.is_open()) {
+            std::fprintf(stderr, "Failed to open '%s'\n", a_options.keysFile.c_str());
+            return false;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                if (a_stream.frameEnds.empty() || a_stream.frameEnds.back() != a_stream.keys.size()) {
+                    a_stream.frameEnds.push_back(a_stream.keys.size());
+                }
+                continue;
+            }
+            a_stream.keys.push_back(Text::Utf8ToWide(line));
+        }
+        return !a_stream.keys.empty();
+    }
+
+    bool LoadTrace(const Options& a_options, KeyStream& a_stream) {
+        Trace::Capture capture;
+        if (!Trace::Load(a_options.traceFile, capture) || capture.records.empty()) {
+            return false;
+        }
+
+        std::unordered_map<std::uint32_t, std::wstring> wideKeys;
+        for (const auto& [id, key] : capture.keys) {
+            wideKeys.emplace(id, Text::Utf8ToWide(key));
+        }
+
+        const auto frameNs = a_options.frameUs * 1000;
+        auto frame = capture.records.front().timestampNs / frameNs;
+        for (const auto& record : capture.records) {
+            if (const auto recordFrame = record.timestampNs / frameNs; recordFrame != frame) {
+                a_stream.frameEnds.push_back(a_stream.keys.size());
+                frame = recordFrame;
+            }
+            a_stream.keys.push_back(wideKeys[record.keyId]);
+            a_stream.kinds.push_back(record.provider < ProviderKind::kTotal ? record.provider : ProviderKind::kNone);
+            a_stream.recordedNs.push_back(record.latencyNs);
+        }
+        std::printf("trace: %zu calls, %zu distinct keys, %zu frames\n", a_stream.keys.size(), capture.keys.size(),
+                    a_stream.frameEnds.size() + 1);
+        return true;
+    }
+
+    // Menu-like traffic: a few keys are hot, most are rare. Every 16th key belongs to a prefix-registered family.
+    void SynthesizeKeyStream(const Options& a_options, KeyStream& a_stream) {
+        constexpr std::size_t kDistinctKeys = 4096;
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        a_stream.keys.reserve(a_options.calls);
+        for (std::size_t i = 0; i < a_options.calls; ++i) {
+            const auto index = static_cast<std::size_t>(std::pow(dist(rng), 3.0) * kDistinctKeys);
+            a_stream.keys.push_back(index % 16 == 0 ? Widen("$BenchFamily_" + std::to_string(index))
+                                                    : Widen("$BenchKey_" + std::to_string(index)));
+        }
+    }
+
+    void FillFrameEnds(const Options& a_options, KeyStream& a_stream) {
+        if (!a_stream.frameEnds.empty()) {
+            return;
+        }
+        for (auto end = a_options.keysPerFrame; end < a_stream.keys.size(); end += a_options.keysPerFrame) {
+            a_stream.frameEnds.push_back(end);
+        }
+    }
+
+    // Hash-picked provider kinds for streams without recorded ones; about one key in ten stays vanilla
+    ProviderKind PickKind(const std::string& a_key) {
+        constexpr std::array kKinds{ProviderKind::kNative,  ProviderKind::kNative,         ProviderKind::kNative,
+                                    ProviderKind::kNative,  ProviderKind::kNativeMemoized, ProviderKind::kNativeMemoized,
+                                    ProviderKind::kBatch,   ProviderKind::kBatch,          ProviderKind::kPapyrus,
+                                    ProviderKind::kNone};
+        return kKinds[std::hash<std::string>{}(a_key) % kKinds.size()];
+    }
+
+    // Registers every distinct key with a mock of its provider kind
+    void BuildRegistry(const KeyStream& a_stream, MockTranslator& a_translator) {
+        Provider native{};
+        native.native = MockNative;
+        native.statsId = Stats::RegisterProvider("MockNative");
+        native.breaker = std::make_shared<CircuitBreaker>("MockNative");
+
+        Provider memoized = native;
+        memoized.memoize = true;
+        memoized.statsId = Stats::RegisterProvider("MockNativeMemoized");
+        memoized.breaker = std::make_shared<CircuitBreaker>("MockNativeMemoized");
+
+        Provider batch{};
+        batch.batch = std::make_shared<NativeBatchGroup>("MockBatch", MockBatch);
+        batch.memoize = true;
+        batch.statsId = Stats::RegisterProvider("MockBatch");
+        batch.breaker = std::make_shared<CircuitBreaker>("MockBatch");
+
+        Provider papyrus{};
+        papyrus.scriptID = {0x800, "MockQuest"};
+        papyrus.statsId = Stats::RegisterProvider("MockQuest");
+        papyrus.breaker = std::make_shared<CircuitBreaker>("MockQuest");
+
+        KeyIndex::Source source;
+        const auto nativeId = source.Intern(native);
+        const auto memoizedId = source.Intern(memoized);
+        const auto batchId = source.Intern(batch);
+        const auto papyrusId = source.Intern(papyrus);
+        if (a_stream.kinds.empty()) {
+            source.keys.emplace_back("BenchFamily_*", nativeId);
+        }
+        std::unordered_set<std::wstring_view> seen;
+        for (std::size_t i = 0; i < a_stream.keys.size(); ++i) {
+            const auto& wideKey = a_stream.keys[i];
+            if (!seen.insert(wideKey).second || (a_stream.kinds.empty() && wideKey.starts_with(L"$BenchFamily_"))) {
+                continue;
+            }
+            if (wideKey.size() < 2 || wideKey[0] != L'$') {
+                a_translator.Add(wideKey);
+                continue;
+            }
+            auto key = Text::WideToUtf8(wideKey.c_str() + 1);
+            switch (a_stream.kinds.empty() ? PickKind(key) : a_stream.kinds[i]) {
+                case ProviderKind::kNative:
+                    source.keys.emplace_back(std::move(key), nativeId);
+                    break;
+                case ProviderKind::kNativeMemoized:
+                    source.keys.emplace_back(std::move(key), memoizedId);
+                    break;
+                case ProviderKind::kBatch:
+                    source.keys.emplace_back(std::move(key), batchId);
+                    break;
+                case ProviderKind::kPapyrus:
+                    source.keys.emplace_back(std::move(key), papyrusId);
+                    break;
+                case ProviderKind::kUnregistered:
+                    PushResult(key, "Pushed " + key);
+                    break;
+                default:
+                    a_translator.Add(wideKey);
+                    break;
+            }
+        }
+
+        auto index = std::make_unique<KeyIndex>();
+        index->Build(std::move(source));
+        ProviderRegistry::Publish(std::move(index));
+    }
+
+    // The hook's lookup before the key index: every key is transcoded to UTF-8 and stripped of its '$', and the
+    // provider is copied out of a map under a shared lock. Providers are invoked the same way, so only the lookup
+    // differs from TranslateKey.
+    class BaselineLookup {
+    public:
+        // Same key to provider assignment as the published registry. The map only knew exact keys, so prefix families
+        // are expanded to the keys the stream uses.
+        explicit BaselineLookup(const KeyStream& a_stream) {
+            const ProviderRegistry::ReadGuard registry;
+            for (const auto& key : a_stream.keys) {
+                if (key.size() < 2 || key[0] != L'$') {
+                    continue;
+                }
+                auto entry = registry->Find(key.c_str());
+                if (!entry) {
+                    entry = registry->FindPrefix(key.c_str());
+                }
+                if (entry) {
+                    providers.emplace(Text::WideToUtf8(key.c_str() + 1), Bound(registry->ProviderOf(*entry)));
+                }
+            }
+        }
+
+        std::wstring Translate(const std::wstring& a_key) const {
+            auto keyUtf8 = Text::WideToUtf8(a_key.c_str());
+            if (keyUtf8.empty() || keyUtf8[0] != '$') {
+                return {};
+            }
+            keyUtf8 = keyUtf8.substr(1);
+
+            Provider prov{};
+            {
+                std::shared_lock lock(mutex);
+                if (const auto it = providers.find(keyUtf8); it != providers.end()) {
+                    prov = it->second;
+                }
+            }
+            return InvokeProvider(prov, keyUtf8);
+        }
+
+    private:
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Provider> providers;
+    };
+
+    struct PassResult {
+        std::vector<std::uint64_t> latenciesNs;
+        Clock::duration wall{};
+        std::uint64_t allocations{};
+        std::uint64_t bytes{};
+        std::uint64_t translated{};
+    };
+
+    // a_translate is the core's half of the hook: a GFx key in, the provider's text (or nothing) out
+    template <class Translate>
+    void RunPass(const KeyStream& a_stream, const MockTranslator& a_translator, MockHost& a_host,
+                 PassResult& a_result, Translate&& a_translate) {
+        a_result.latenciesNs.clear();
+        a_result.latenciesNs.reserve(a_stream.keys.size());
+        std::wstring result;
+        result.reserve(256);
+
+        auto frameEnd = a_stream.frameEnds.begin();
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < a_stream.keys.size(); ++i) {
+            if (frameEnd != a_stream.frameEnds.end() && *frameEnd == i) {
+                a_host.AdvanceFrame();
+                ++frameEnd;
+            }
+
+            const auto& key = a_stream.keys[i];
+            const auto allocsBefore = allocations.load(std::memory_order_relaxed);
+            const auto bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+            const auto callStart = Clock::now();
+
+            // Same sequence as the game hook: original translation first, then the core
+            a_translator.Translate(key, result);
+            if (const auto body = a_translate(key); !body.empty()) {
+                result = body;
+                ++a_result.translated;
+            }
+
+            const auto elapsed = Clock::now() - callStart;
+            a_result.allocations += allocations.load(std::memory_order_relaxed) - allocsBefore;
+            a_result.bytes += allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+            a_result.latenciesNs.push_back(
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        a_host.AdvanceFrame();
+        a_result.wall = Clock::now() - start;
+        // A pass ends like a menu closing
+        DynamicTranslationSE::PruneDispatchStates();
+    }
+
+    // a_sorted must be sorted and non-empty
+    std::uint64_t Quantile(const std::vector<std::uint64_t>& a_sorted, const double a_q) {
+        const auto index = static_cast<std::size_t>(a_q * static_cast<double>(a_sorted.size()));
+        return a_sorted[std::min(a_sorted.size() - 1, index)];
+    }
+
+    // Recorded in-game latency next to the replayed one, per provider kind
+    void PrintComparison(const KeyStream& a_stream, const PassResult& a_result) {
+        constexpr auto kKinds = static_cast<std::size_t>(ProviderKind::kTotal);
+        std::array<std::vector<std::uint64_t>, kKinds> recorded;
+        std::array<std::vector<std::uint64_t>, kKinds> replayed;
+        for (std::size_t i = 0; i < a_stream.kinds.size(); ++i) {
+            const auto kind = static_cast<std::size_t>(a_stream.kinds[i]);
+            recorded[kind].push_back(a_stream.recordedNs[i]);
+            replayed[kind].push_back(a_result.latenciesNs[i]);
+        }
+
+        std::printf("  %-16s %10s %12s %12s %12s %12s\n", "provider", "calls", "game p50", "replay p50", "game p99",
+                    "replay p99");
+        for (std::size_t kind = 0; kind < kKinds; ++kind) {
+            if (recorded[kind].empty()) {
+                continue;
+            }
+            std::sort(recorded[kind].begin(), recorded[kind].end());
+            std::sort(replayed[kind].begin(), replayed[kind].end());
+            std::printf("  %-16s %10zu %12llu %12llu %12llu %12llu\n", kKindNames[kind], recorded[kind].size(),
+                        static_cast<unsigned long long>(Quantile(recorded[kind], 0.5)),
+                        static_cast<unsigned long long>(Quantile(replayed[kind], 0.5)),
+                        static_cast<unsigned long long>(Quantile(recorded[kind], 0.99)),
+                        static_cast<unsigned long long>(Quantile(replayed[kind], 0.99)));
+        }
+    }
+
+    void PrintPass(const char* a_name, const std::size_t a_pass, const KeyStream& a_stream,
+                   const PassResult& a_result) {
+        if (a_result.latenciesNs.empty()) {
+            return;
+        }
+
+        auto ns = a_result.latenciesNs;
+        const auto calls = ns.size();
+        std::sort(ns.begin(), ns.end());
+        const auto quantile = [&](const double a_q) { return Quantile(ns, a_q); };
+        std::uint64_t sum = 0;
+        for (const auto n : ns) {
+            sum += n;
+        }
+        const auto seconds = std::chrono::duration<double>(a_result.wall).count();
+
+        std::printf("%s %zu: %zu calls (%llu translated) in %.3f s, %.0f calls/s\n", a_name, a_pass, calls,
+                    static_cast<unsigned long long>(a_result.translated), seconds,
+                    static_cast<double>(calls) / seconds);
+        std::printf("  latency ns: mean %llu  p50 %llu  p90 %llu  p99 %llu  p99.9 %llu  max %llu\n",
+                    static_cast<unsigned long long>(sum / calls), static_cast<unsigned long long>(quantile(0.5)),
+                    static_cast<unsigned long long>(quantile(0.9)), static_cast<unsigned long long>(quantile(0.99)),
+                    static_cast<unsigned long long>(quantile(0.999)), static_cast<unsigned long long>(ns.back()));
+        std::printf("  allocations/call: %.3f  bytes/call: %.1f\n",
+                    static_cast<double>(a_result.allocations) / static_cast<double>(calls),
+                    static_cast<double>(a_result.bytes) / static_cast<double>(calls));
+        if (!a_stream.kinds.empty()) {
+            PrintComparison(a_stream, a_result);
+        }
+    }
+
+    // Stand-ins for a quest stage and a global the rules read; both change every frame
+    float mockStage = 0.0f;
+    float mockHour = 0.0f;
+
+    float ReadMockValue(const void* a_context, std::uint32_t) {
+        return *static_cast<const float*>(a_context);
+    }
+
+    // The same four-way choice served by a compiled rule set and by a Papyrus script. Papyrus answers come from the
+    // result cache and are a round trip (--papyrus-delay-frames) behind; the rules read the values in the call.
+    void RunRuleComparison(const Options& a_options, MockHost& a_host) {
+        const std::vector<Rules::RuleSource> sources{
+            {{"quest:MockStage >= 30"}, "The war is over", {}},
+            {{"quest:MockStage >= 10", "global:MockHour < 12"}, "Stage {}, morning", {"quest:MockStage"}},
+            {{"quest:MockStage >= 10"}, "Stage {} at {} hours", {"quest:MockStage", "global:MockHour"}},
+            {{}, "Not started", {}}};
+        const auto resolve = [](const std::string_view a_kind, std::string_view) -> std::optional<Rules::Operand> {
+            return Rules::Operand{ReadMockValue, a_kind == "quest" ? &mockStage : &mockHour, 0};
+        };
+
+        Provider rules{};
+        rules.rules = Rules::RuleSet::Compile(sources, resolve, "MockRules");
+        rules.statsId = Stats::RegisterProvider("MockRules");
+
+        Provider papyrus{};
+        papyrus.scriptID = {0x801, "MockRuleQuest"};
+        papyrus.statsId = Stats::RegisterProvider("MockRuleQuest");
+        papyrus.breaker = std::make_shared<CircuitBreaker>("MockRuleQuest");
+
+        // Few enough keys that every Papyrus dispatch fits under kMaxConcurrentPapyrusDispatches
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < 16; ++i) {
+            keys.push_back(fmt::format("BenchRule_{}", i));
+        }
+
+        const auto run = [&](const char* a_name, const Provider& a_provider) {
+            std::vector<std::uint64_t> ns;
+            ns.reserve(a_options.calls);
+            std::uint64_t allocs = 0;
+            std::uint64_t empty = 0;
+            for (std::size_t i = 0; i < a_options.calls; ++i) {
+                if (i % keys.size() == 0) {
+                    a_host.AdvanceFrame();
+                    mockStage = static_cast<float>((i / keys.size()) % 40);
+                    mockHour = static_cast<float>((i / keys.size()) % 24);
+                }
+                const auto allocsBefore = allocations.load(std::memory_order_relaxed);
+                const auto callStart = Clock::now();
+                const auto text = InvokeProvider(a_provider, keys[i % keys.size()]);
+                const auto elapsed = Clock::now() - callStart;
+                allocs += allocations.load(std::memory_order_relaxed) - allocsBefore;
+                empty += text.empty();
+                ns.push_back(
+                    static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+            if (ns.empty()) {
+                return;
+            }
+            std::sort(ns.begin(), ns.end());
+            std::uint64_t sum = 0;
+            for (const auto n : ns) {
+                sum += n;
+            }
+            std::printf("  %-8s mean %llu  p50 %llu  p99 %llu ns  allocations/call %.3f  untranslated %llu\n", a_name,
+                        static_cast<unsigned long long>(sum / ns.size()),
+                        static_cast<unsigned long long>(Quantile(ns, 0.5)),
+                        static_cast<unsigned long long>(Quantile(ns, 0.99)),
+                        static_cast<double>(allocs) / static_cast<double>(ns.size()),
+                        static_cast<unsigned long long>(empty));
+        };
+
+        std::printf("rules vs papyrus: %zu calls over %zu keys, Papyrus values %llu frames behind\n", a_options.calls,
+                    keys.size(), static_cast<unsigned long long>(a_options.papyrusDelayFrames));
+        run("rules", rules);
+        run("papyrus", papyrus);
+    }
+
+    // A menu showing a_options.batchKeys keys of one batch DLL, translated once per frame. The first frame opens the
+    // menu with nothing cached; the keys it could not serve arrive with the flush at its end, and the frames after it
+    // are steady. Returns false if the opening frame took more than two calls or a steady frame more than one, for
+    // every kMaxBatchKeys keys.
+    bool RunBatchBench(const Options& a_options, MockHost& a_host) {
+        constexpr std::size_t kSteadyFrames = 30;
+        bool ok = true;
+        for (const bool memoize : {true, false}) {
+            Provider batch{};
+            batch.batch = std::make_shared<NativeBatchGroup>("CountingBatch", CountingBatch);
+            batch.memoize = memoize;
+            batch.statsId = Stats::RegisterProvider("CountingBatch");
+
+            std::vector<std::string> keys;
+            for (std::size_t i = 0; i < a_options.batchKeys; ++i) {
+                keys.push_back(fmt::format("BenchBatch{}_{}", memoize ? "Memoized" : "PerFrame", i));
+            }
+
+            std::uint64_t openCalls = 0, openKeys = 0, openUntranslated = 0, steadyCalls = 0, steadyKeys = 0;
+            std::uint64_t worstCalls = 0, untranslated = 0;
+            double openUs = 0.0;
+            a_host.AdvanceFrame();
+            for (std::size_t frame = 0; frame <= kSteadyFrames; ++frame) {
+                const auto callsBefore = batchCalls.load(std::memory_order_relaxed);
+                const auto keysBefore = batchCallKeys.load(std::memory_order_relaxed);
+                std::uint64_t empty = 0;
+                const auto start = Clock::now();
+                for (const auto& key : keys) {
+                    empty += InvokeProvider(batch, key).empty();
+                }
+                // Ends the frame, which flushes what was deferred in it
+                a_host.AdvanceFrame();
+                const auto elapsedUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+                const auto calls = batchCalls.load(std::memory_order_relaxed) - callsBefore;
+                const auto callKeys = batchCallKeys.load(std::memory_order_relaxed) - keysBefore;
+                if (frame == 0) {
+                    openCalls = calls;
+                    openKeys = callKeys;
+                    openUntranslated = empty;
+                    openUs = elapsedUs;
+                } else {
+                    steadyCalls += calls;
+                    steadyKeys += callKeys;
+                    worstCalls = std::max(worstCalls, calls);
+                    untranslated += empty;
+                }
+            }
+            // One call per kMaxBatchKeys keys, plus the call for the first key of the opening frame
+            constexpr std::size_t kPerCall = NativeBatchGroup::kMaxBatchKeys;
+            const auto callsPerFrame = (keys.size() + kPerCall - 1) / kPerCall;
+            const auto openLimit = 1 + (keys.size() - 1 + kPerCall - 1) / kPerCall;
+            ok = ok && openCalls <= openLimit && worstCalls <= callsPerFrame;
+
+            std::printf("batch %s: %zu keys, menu open %llu calls carrying %llu keys in %.0f us, %llu untranslated "
+                        "until the refresh\n",
+                        memoize ? "memoized" : "per frame", keys.size(), static_cast<unsigned long long>(openCalls),
+                        static_cast<unsigned long long>(openKeys), openUs,
+                        static_cast<unsigned long long>(openUntranslated));
+            std::printf("  steady frames: %.1f calls and %.1f keys per frame, at most %llu calls, %llu untranslated\n",
+                        static_cast<double>(steadyCalls) / kSteadyFrames,
+                        static_cast<double>(steadyKeys) / kSteadyFrames,
+                        static_cast<unsigned long long>(worstCalls), static_cast<unsigned long long>(untranslated));
+        }
+        return ok;
+    }
+
+    // Mean time per call of a_lookup over a_keys in shuffled order, repeated to at least a_calls calls.
+    // a_foundShare receives the share of calls that found an entry.
+    template <class Lookup>
+    double MeanLookupNs(const std::vector<std::wstring>& a_keys, const std::size_t a_calls, double& a_foundShare,
+                        Lookup&& a_lookup) {
+        std::vector<const wchar_t*> order;
+        order.reserve(a_keys.size());
+        for (const auto& key : a_keys) {
+            order.push_back(key.c_str());
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937_64(7));
+
+        std::size_t found = 0;
+        std::size_t calls = 0;
+        const auto start = Clock::now();
+        while (calls < a_calls) {
+            for (const auto key : order) {
+                found += static_cast<bool>(a_lookup(key));
+            }
+            calls += order.size();
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        a_foundShare = static_cast<double>(found) / static_cast<double>(calls);
+        return elapsed / static_cast<double>(calls);
+    }
+
+    struct WideViewHash {
+        using is_transparent = void;
+        std::size_t operator()(const std::wstring_view a_str) const noexcept {
+            return std::hash<std::wstring_view>{}(a_str);
+        }
+    };
+
+    // A large translation pack: a_options.indexKeys keys spread over 64 config entries, each its own Papyrus script,
+    // plus one prefix family per entry ("DTFPack07_Dynamic_*") whose members add up to a quarter as many keys again,
+    // and a cached result for every exact key. The same pack is also loaded into the structures the key index
+    // replaced, with every family expanded to its members: the plugin's original map of UTF-8 keys to Provider
+    // copies, looked up by transcoding each key as the original hook did, and a map of exact UTF-16 keys.
+    void RunIndexBench(const Options& a_options) {
+        constexpr std::size_t kEntries = 64;
+        const auto keyCount = a_options.indexKeys;
+        const auto familySize = std::max<std::size_t>(1, keyCount / 4 / kEntries);
+        const auto keyName = [](const std::size_t a_entry, const std::size_t a_key) {
+            return fmt::format("DTFPack{:02}_Quest_Objective_{:06}", a_entry, a_key);
+        };
+        const auto familyName = [](const std::size_t a_entry) { return fmt::format("DTFPack{:02}_Dynamic_", a_entry); };
+
+        std::vector<std::wstring> hits;
+        std::vector<std::wstring> misses;
+        std::vector<std::wstring> familyHits;
+        hits.reserve(keyCount);
+        misses.reserve(keyCount);
+        familyHits.reserve(familySize * kEntries);
+        for (std::size_t i = 0; i < keyCount; ++i) {
+            hits.push_back(L"$" + Text::Utf8ToWide(keyName(i % kEntries, i)));
+            misses.push_back(L"$" + Text::Utf8ToWide(keyName(i % kEntries, i + keyCount)));
+        }
+        for (std::size_t entry = 0; entry < kEntries; ++entry) {
+            for (std::size_t member = 0; member < familySize; ++member) {
+                familyHits.push_back(L"$" + Text::Utf8ToWide(fmt::format("{}{:06}", familyName(entry), member)));
+            }
+        }
+
+        KeyIndex::Source pack;
+        std::vector<std::uint32_t> entryProviders;
+        for (std::size_t entry = 0; entry < kEntries; ++entry) {
+            Provider papyrus{};
+            papyrus.scriptID = {static_cast<std::uint32_t>(0x900 + entry), fmt::format("DTFPack{:02}Quest", entry)};
+            entryProviders.push_back(pack.Intern(papyrus));
+        }
+        for (std::size_t i = 0; i < keyCount; ++i) {
+            pack.keys.emplace_back(keyName(i % kEntries, i), entryProviders[i % kEntries]);
+        }
+        for (std::size_t entry = 0; entry < kEntries; ++entry) {
+            pack.keys.emplace_back(familyName(entry) + "*", entryProviders[entry]);
+        }
+
+        const auto before = liveBytes.load(std::memory_order_relaxed);
+        const auto buildStart = Clock::now();
+        auto index = std::make_unique<KeyIndex>();
+        index->Build(pack);
+        const auto buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+        const auto indexBytes = liveBytes.load(std::memory_order_relaxed) - before;
+
+        const auto originalBefore = liveBytes.load(std::memory_order_relaxed);
+        const auto originalStart = Clock::now();
+        std::unordered_map<std::string, Provider> originalKeys;
+        originalKeys.reserve(keyCount + familyHits.size());
+        for (std::size_t i = 0; i < keyCount; ++i) {
+            originalKeys.emplace(keyName(i % kEntries, i), index->ProviderOf(*index->Find(hits[i].c_str())));
+        }
+        for (std::size_t i = 0; i < familyHits.size(); ++i) {
+            originalKeys.emplace(Text::WideToUtf8(familyHits[i].c_str() + 1),
+                                 index->ProviderOf(*index->FindPrefix(familyHits[i].c_str())));
+        }
+        const auto originalMs = std::chrono::duration<double, std::milli>(Clock::now() - originalStart).count();
+        const auto originalBytes = liveBytes.load(std::memory_order_relaxed) - originalBefore;
+
+        // The providers are shared with the index, as the plugin shares them between entries
+        const auto mapBefore = liveBytes.load(std::memory_order_relaxed);
+        const auto mapStart = Clock::now();
+        std::unordered_map<std::wstring, std::uint32_t, WideViewHash, std::equal_to<>> exactKeys;
+        exactKeys.reserve(keyCount + familyHits.size());
+        for (std::size_t i = 0; i < keyCount; ++i) {
+            exactKeys.emplace(hits[i], entryProviders[i % kEntries]);
+        }
+        for (std::size_t i = 0; i < familyHits.size(); ++i) {
+            exactKeys.emplace(familyHits[i], entryProviders[i / familySize]);
+        }
+        const auto mapMs = std::chrono::duration<double, std::milli>(Clock::now() - mapStart).count();
+        const auto mapBytes = liveBytes.load(std::memory_order_relaxed) - mapBefore;
+
+        ResultCache results{std::size_t{1} << 30};
+        const auto cacheBefore = liveBytes.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < keyCount; ++i) {
+            results.Put(keyName(i % kEntries, i), std::wstring_view(hits[i]).substr(1));
+        }
+        const auto cacheBytes = liveBytes.load(std::memory_order_relaxed) - cacheBefore;
+
+        const auto calls = std::max<std::size_t>(a_options.calls, keyCount);
+        const auto measure = [&](const char* a_name, auto&& a_find) {
+            double hitShare = 0.0, missShare = 0.0, familyShare = 0.0;
+            const auto hitNs = MeanLookupNs(hits, calls, hitShare, a_find);
+            const auto missNs = MeanLookupNs(misses, calls, missShare, a_find);
+            const auto familyNs = MeanLookupNs(familyHits, calls, familyShare, a_find);
+            std::printf("  %s lookup ns: hit %.1f (%.0f%% found)  miss %.1f (%.0f%% found)  "
+                        "family hit %.1f (%.0f%% found)\n",
+                        a_name, hitNs, hitShare * 100.0, missNs, missShare * 100.0, familyNs, familyShare * 100.0);
+        };
+
+        std::printf("registry: %zu keys + %zu prefix families of %zu keys, %zu providers\n", keyCount, kEntries,
+                    familySize, index->ProviderCount());
+        std::printf("  key index: built in %.1f ms, heap %lld bytes (%.1f per key)\n", buildMs,
+                    static_cast<long long>(indexBytes),
+                    static_cast<double>(indexBytes) / static_cast<double>(keyCount));
+        std::printf("  original map (families expanded, %zu keys): built in %.1f ms, heap %lld bytes (%.1f per key)\n",
+                    originalKeys.size(), originalMs, static_cast<long long>(originalBytes),
+                    static_cast<double>(originalBytes) / static_cast<double>(originalKeys.size()));
+        std::printf("  exact-key map (families expanded, %zu keys): built in %.1f ms, heap %lld bytes "
+                    "(%.1f per key)\n",
+                    exactKeys.size(), mapMs, static_cast<long long>(mapBytes),
+                    static_cast<double>(mapBytes) / static_cast<double>(exactKeys.size()));
+        std::printf("  result cache heap %lld bytes (%.1f per entry)\n", static_cast<long long>(cacheBytes),
+                    static_cast<double>(cacheBytes) / static_cast<double>(keyCount));
+        measure("key index", [&](const wchar_t* a_key) {
+            const auto entry = index->Find(a_key);
+            return entry ? entry : index->FindPrefix(a_key);
+        });
+        measure("original map", [&](const wchar_t* a_key) -> const Provider* {
+            const auto key = Text::WideToUtf8(a_key);
+            if (key.empty() || key[0] != '$') {
+                return nullptr;
+            }
+            const auto it = originalKeys.find(key.substr(1));
+            return it != originalKeys.end() ? &it->second : nullptr;
+        });
+        measure("exact-key map", [&](const wchar_t* a_key) {
+            const auto it = exactKeys.find(std::wstring_view(a_key));
+            return it != exactKeys.end() ? &it->second : nullptr;
+        });
+    }
+
+#if DTF_HAS_CONFIG_PARSER
+    // A large load order: a_options.configFiles files of four entries each (a Papyrus script, a DLL, a rule provider
+    // and an async DLL with a Papyrus fallback), every entry registering 16 keys. Every eighth file also registers keys
+    // of the file before it, so the merge resolves overrides too.
+    bool RunConfigBench(const Options& a_options) {
+        constexpr std::size_t kEntriesPerFile = 4;
+        constexpr std::size_t kKeysPerEntry = 16;
+        constexpr std::size_t kOverrides = 4;
+        constexpr std::size_t kRuns = 5;
+        const auto fileCount = a_options.configFiles;
+        const auto keyName = [](const std::size_t a_file, const std::size_t a_entry, const std::size_t a_key) {
+            return fmt::format("DTFConfig{:05}_Entry{}_Key{:02}", a_file, a_entry, a_key);
+        };
+
+        const auto folder = std::filesystem::temp_directory_path() / "DynamicTranslationBench.configs";
+        std::error_code ec;
+        std::filesystem::remove_all(folder, ec);
+        std::filesystem::create_directories(folder, ec);
+        if (ec) {
+            std::fprintf(stderr, "Failed to create '%s': %s\n", folder.string().c_str(), ec.message().c_str());
+            return false;
+        }
+
+        std::uintmax_t folderBytes = 0;
+        for (std::size_t file = 0; file < fileCount; ++file) {
+            std::string json = "[\n";
+            for (std::size_t entry = 0; entry < kEntriesPerFile; ++entry) {
+                std::string strings;
+                for (std::size_t key = 0; key < kKeysPerEntry; ++key) {
+                    strings += fmt::format("{}\"{}\"", strings.empty() ? "" : ", ", keyName(file, entry, key));
+                }
+                if (file % 8 == 7 && entry == 0) {
+                    for (std::size_t key = 0; key < kOverrides; ++key) {
+                        strings += fmt::format(", \"{}\"", keyName(file - 1, entry, key));
+                    }
+                }
+                switch (entry) {
+                case 0:
+                    json += fmt::format(R"(  {{"papyrus": "DTFConfigQuest{}", "refresh": "interval", )"
+                                        R"("refreshIntervalMs": 500, "strings": [{}]}})",
+                                        file, strings);
+                    break;
+                case 1:
+                    json += fmt::format(R"(  {{"skse": "DTFConfig{}.dll", "memoize": true, "ttlMs": 1000, )"
+                                        R"("budgetUs": 200, "strings": [{}]}})",
+                                        file, strings);
+                    break;
+                case 2:
+                    json += fmt::format(R"(  {{"rules": [{{"when": ["quest:DTFConfigQuest{} >= 10", )"
+                                        R"("global:GameHour < 12"], "text": "{{}} hours left", )"
+                                        R"("args": ["global:Timer"]}}, {{"text": "Later"}}], "strings": [{}]}})",
+                                        file, strings);
+                    break;
+                default:
+                    json += fmt::format(R"(  {{"skse": "DTFConfigAsync{}.dll", "async": true, "asyncQueueLimit": 32, )"
+                                        R"("papyrus": "DTFConfigFallback{}", "refresh": "event", "strings": [{}]}})",
+                                        file, file, strings);
+                    break;
+                }
+                json += entry + 1 < kEntriesPerFile ? ",\n" : "\n";
+            }
+            json += "]\n";
+            std::ofstream out(folder / fmt::format("DTFConfig{:05}.json", file), std::ios::binary);
+            out.write(json.data(), static_cast<std::streamsize>(json.size()));
+            folderBytes += json.size();
+        }
+
+        double parseBest = 0.0, parseSum = 0.0, mergeBest = 0.0, mergeSum = 0.0;
+        RegistrySpec spec;
+        for (std::size_t run = 0; run < kRuns; ++run) {
+            // Listed and sorted like ConfigLoader::Load does, so the directory walk is part of the parse time
+            const auto start = Clock::now();
+            std::vector<ConfigFile> files;
+            for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+                files.push_back({entry.path(), entry.path().string(), {}});
+            }
+            std::ranges::sort(files, {}, [](const ConfigFile& a_file) { return a_file.path.filename(); });
+            ConfigParser::ParseFiles(files);
+            const auto parsed = Clock::now();
+            spec = ConfigParser::Merge(files);
+            const auto merged = Clock::now();
+
+            const auto parseMs = std::chrono::duration<double, std::milli>(parsed - start).count();
+            const auto mergeMs = std::chrono::duration<double, std::milli>(merged - parsed).count();
+            parseBest = run ? std::min(parseBest, parseMs) : parseMs;
+            mergeBest = run ? std::min(mergeBest, mergeMs) : mergeMs;
+            parseSum += parseMs;
+            mergeSum += mergeMs;
+        }
+        // Warm start: the same result read back from the registry cache image instead
+        Manifest manifest;
+        for (std::size_t file = 0; file < fileCount; ++file) {
+            const auto name = fmt::format("DTFConfig{:05}.json", file);
+            manifest.push_back({name, std::filesystem::file_size(folder / name, ec), static_cast<std::int64_t>(file)});
+        }
+        const auto imagePath = folder / "registry.bin";
+        RegistryCache::Write(imagePath, manifest, spec);
+        double warmBest = 0.0;
+        bool warmOk = true;
+        for (std::size_t run = 0; run < kRuns; ++run) {
+            RegistrySpec cached;
+            const auto start = Clock::now();
+            warmOk = RegistryCache::Read(imagePath, manifest, cached) && warmOk;
+            const auto readMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            warmBest = run ? std::min(warmBest, readMs) : readMs;
+            warmOk = warmOk && cached == spec;
+        }
+        std::filesystem::remove_all(folder, ec);
+
+        // Overrides add no keys, and the last file to register a key owns it
+        const auto expectedKeys = fileCount * kEntriesPerFile * kKeysPerEntry;
+        bool ok = spec.keys.size() == expectedKeys && spec.entries.size() == fileCount * kEntriesPerFile;
+        if (ok && fileCount >= 8) {
+            const auto it = spec.keys.find(keyName(6, 0, 0));
+            ok = it != spec.keys.end() && spec.entries[it->second].papyrus == "DTFConfigQuest7";
+        }
+
+        std::printf("config: %zu files (%.1f KB), %zu entries, %zu keys\n", fileCount,
+                    static_cast<double>(folderBytes) / 1024.0, spec.entries.size(), spec.keys.size());
+        std::printf("  read + parse ms: best %.2f  mean %.2f (%.1f MB/s)  merge ms: best %.2f  mean %.2f\n", parseBest,
+                    parseSum / kRuns, static_cast<double>(folderBytes) / (parseBest * 1000.0), mergeBest,
+                    mergeSum / kRuns);
+        std::printf("  cold start (read + parse + merge) best %.2f ms, warm start (registry image) best %.2f ms\n",
+                    parseBest + mergeBest, warmBest);
+        if (!ok) {
+            std::printf("  merged registry differs from the generated configs\n");
+        }
+        if (!warmOk) {
+            std::printf("  registry image read back differs from the merged registry\n");
+        }
+        return ok && warmOk;
+    }
+#else
+    bool RunConfigBench(const Options&) {
+        std::fprintf(stderr, "--config-files needs a core built with RapidJSON\n");
+        return false;
+    }
+#endif
+
+    // The registry cache image of a pack of a_options.registryCacheKeys keys over 64 entries that between them set
+    // every option, written and read back from a temporary file
+    bool RunRegistryCacheBench(const Options& a_options) {
+        constexpr std::size_t kEntries = 64;
+        constexpr std::size_t kConfigFiles = 16;
+        constexpr std::size_t kRuns = 5;
+
+        RegistrySpec spec;
+        for (std::size_t e = 0; e < kEntries; ++e) {
+            EntrySpec entry;
+            entry.dll = e % 2 ? fmt::format("DTFPack{:02}.dll", e) : "";
+            entry.papyrus = e % 3 ? fmt::format("DTFPack{:02}Quest", e) : "";
+            entry.refresh = static_cast<RefreshPolicy>(e % 3);
+            entry.refreshIntervalMs = static_cast<std::uint32_t>(e * 10);
+            entry.ttlMs = static_cast<std::uint32_t>(e * 100);
+            entry.memoize = e % 2 == 0;
+            entry.async = e % 4 == 1;
+            entry.asyncQueueLimit = static_cast<std::uint32_t>(e);
+            entry.budgetUs = static_cast<std::uint32_t>(100 + e);
+            entry.rules = e % 5 == 0 ? R"([{"when":["global:GameHour < 12"],"text":"Morning"}])" : "";
+            spec.entries.push_back(std::move(entry));
+        }
+        for (std::size_t i = 0; i < a_options.registryCacheKeys; ++i) {
+            spec.keys.emplace(fmt::format("DTFPack{:02}_Quest_Objective_{:06}", i % kEntries, i),
+                              static_cast<std::uint32_t>(i % kEntries));
+        }
+        Manifest manifest;
+        for (std::size_t f = 0; f < kConfigFiles; ++f) {
+            manifest.push_back({fmt::format("DTFPack{:02}.json", f), 4096 + f, static_cast<std::int64_t>(1000 + f)});
+        }
+
+        const auto path = std::filesystem::temp_directory_path() / "DynamicTranslationBench.registry";
+        double writeBest = 0.0, readBest = 0.0;
+        bool ok = true;
+        for (std::size_t run = 0; run < kRuns; ++run) {
+            const auto start = Clock::now();
+            RegistryCache::Write(path, manifest, spec);
+            const auto written = Clock::now();
+            RegistrySpec read;
+            ok = RegistryCache::Read(path, manifest, read) && ok;
+            const auto done = Clock::now();
+            ok = ok && read == spec;
+            const auto writeMs = std::chrono::duration<double, std::milli>(written - start).count();
+            const auto readMs = std::chrono::duration<double, std::milli>(done - written).count();
+            writeBest = run ? std::min(writeBest, writeMs) : writeMs;
+            readBest = run ? std::min(readBest, readMs) : readMs;
+        }
+        std::error_code ec;
+        const auto imageBytes = std::filesystem::file_size(path, ec);
+
+        // A touched config file and an image cut short must both send the loader back to the JSON files
+        const auto level = spdlog::get_level();
+        spdlog::set_level(spdlog::level::err);
+        auto touched = manifest;
+        ++touched.back().mtime;
+        RegistrySpec rejected;
+        const bool staleRejected = !RegistryCache::Read(path, touched, rejected);
+        std::filesystem::resize_file(path, imageBytes / 2, ec);
+        const bool truncatedRejected = !RegistryCache::Read(path, manifest, rejected);
+        spdlog::set_level(level);
+        std::filesystem::remove(path, ec);
+
+        std::printf("registry cache: %zu keys, %zu entries, image %.1f KB\n", spec.keys.size(), spec.entries.size(),
+                    static_cast<double>(imageBytes) / 1024.0);
+        std::printf("  write ms: best %.2f  read ms: best %.2f  round trip %s, stale image %s, truncated image %s\n",
+                    writeBest, readBest, ok ? "identical" : "DIFFERS", staleRejected ? "rejected" : "ACCEPTED",
+                    truncatedRejected ? "rejected" : "ACCEPTED");
+        return ok && staleRejected && truncatedRejected && rejected.entries.empty();
+    }
+
+    struct StressResult {
+        std::uint64_t lookups{0};
+        std::uint64_t failures{0};
+        std::uint64_t publishes{0};
+        double seconds{0.0};
+    };
+
+    // a_readers threads call a_lookup(i) for key indices in shuffled order while this thread calls a_publish in a
+    // loop, for a fixed time. a_lookup returns false when key i was not found as expected.
+    template <class Lookup, class Publish>
+    StressResult RunStress(const std::size_t a_readers, const std::size_t a_keys, Lookup&& a_lookup,
+                           Publish&& a_publish) {
+        constexpr auto kDuration = std::chrono::seconds(1);
+        std::atomic_bool stop{false};
+        std::atomic<std::uint64_t> lookups{0};
+        std::atomic<std::uint64_t> failures{0};
+        std::vector<std::thread> readers;
+        for (std::size_t r = 0; r < a_readers; ++r) {
+            readers.emplace_back([&, r] {
+                std::vector<std::size_t> order(a_keys);
+                for (std::size_t i = 0; i < a_keys; ++i) {
+                    order[i] = i;
+                }
+                std::shuffle(order.begin(), order.end(), std::mt19937_64(r));
+                std::uint64_t done = 0;
+                std::uint64_t failed = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    for (const auto i : order) {
+                        failed += !a_lookup(i);
+                    }
+                    done += order.size();
+                }
+                lookups.fetch_add(done, std::memory_order_relaxed);
+                failures.fetch_add(failed, std::memory_order_relaxed);
+            });
+        }
+
+        StressResult result;
+        const auto start = Clock::now();
+        while (Clock::now() - start < kDuration) {
+            a_publish();
+            ++result.publishes;
+        }
+        stop.store(true, std::memory_order_relaxed);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.lookups = lookups.load(std::memory_order_relaxed);
+        result.failures = failures.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    // Lookups against the RCU registry and against the std::shared_mutex design it replaced, under a writer that
+    // republishes as fast as it can. Leaves the stress snapshot published.
+    bool RunRegistryStress(const Options& a_options) {
+        constexpr std::size_t kKeys = 1024;
+        std::vector<std::string> names;
+        std::vector<std::wstring> wideKeys;
+        for (std::size_t i = 0; i < kKeys; ++i) {
+            names.push_back(fmt::format("StressKey_{:04}", i));
+            wideKeys.push_back(L"$" + Text::Utf8ToWide(names.back()));
+        }
+
+        Provider papyrus{};
+        papyrus.scriptID = {0xA00, "StressQuest"};
+        const auto buildIndex = [&] {
+            KeyIndex::Source source;
+            const auto provider = source.Intern(papyrus);
+            for (const auto& name : names) {
+                source.keys.emplace_back(name, provider);
+            }
+            auto index = std::make_unique<KeyIndex>();
+            index->Build(std::move(source));
+            return index;
+        };
+        ProviderRegistry::Publish(buildIndex());
+        const auto rcu = RunStress(
+            a_options.stressReaders, kKeys,
+            [&](const std::size_t a_key) {
+                const ProviderRegistry::ReadGuard registry;
+                const auto entry = registry->Find(wideKeys[a_key].c_str());
+                return entry && entry->key == names[a_key];
+            },
+            [&] { ProviderRegistry::Publish(buildIndex()); });
+
+        using Map = std::unordered_map<std::wstring, std::uint32_t>;
+        const auto buildMap = [&] {
+            auto map = std::make_unique<Map>();
+            for (std::size_t i = 0; i < kKeys; ++i) {
+                map->emplace(wideKeys[i], static_cast<std::uint32_t>(i));
+            }
+            return map;
+        };
+        std::shared_mutex mapMutex;
+        auto map = buildMap();
+        const auto locked = RunStress(
+            a_options.stressReaders, kKeys,
+            [&](const std::size_t a_key) {
+                std::shared_lock lock(mapMutex);
+                const auto it = map->find(wideKeys[a_key]);
+                return it != map->end() && it->second == a_key;
+            },
+            [&] {
+                // Built outside the lock like the registry snapshots; only the swap is exclusive
+                auto fresh = buildMap();
+                std::unique_lock lock(mapMutex);
+                map.swap(fresh);
+            });
+
+        std::printf("registry stress: %zu readers, 1 writer, %zu keys\n", a_options.stressReaders, kKeys);
+        const auto print = [](const char* a_name, const StressResult& a_result) {
+            std::printf("  %-13s %12.0f lookups/s  %8.0f publishes/s  %llu failed lookups\n", a_name,
+                        static_cast<double>(a_result.lookups) / a_result.seconds,
+                        static_cast<double>(a_result.publishes) / a_result.seconds,
+                        static_cast<unsigned long long>(a_result.failures));
+        };
+        print("rcu", rcu);
+        print("shared_mutex", locked);
+        return rcu.failures == 0 && locked.failures == 0;
+    }
+
+    // The converters as they were before the SIMD kernels: one code point at a time into a growing string
+    namespace Reference {
+        constexpr char32_t kReplacement = 0xFFFD;
+
+        std::wstring Utf8ToWide(const std::string_view a_utf8) {
+            std::wstring out;
+            for (std::size_t pos = 0; pos < a_utf8.size();) {
+                const auto lead = static_cast<unsigned char>(a_utf8[pos++]);
+                std::size_t extra = 0;
+                char32_t cp = lead;
+                char32_t min = 0;
+                if (lead >= 0x80) {
+                    if ((lead & 0xE0) == 0xC0) {
+                        extra = 1, cp = lead & 0x1F, min = 0x80;
+                    } else if ((lead & 0xF0) == 0xE0) {
+                        extra = 2, cp = lead & 0x0F, min = 0x800;
+                    } else if ((lead & 0xF8) == 0xF0) {
+                        extra = 3, cp = lead & 0x07, min = 0x10000;
+                    } else {
+                        cp = kReplacement;
+                    }
+                }
+                for (std::size_t i = 0; i < extra; ++i) {
+                    if (pos >= a_utf8.size() || (static_cast<unsigned char>(a_utf8[pos]) & 0xC0) != 0x80) {
+                        cp = kReplacement;
+                        extra = 0;
+                        break;
+                    }
+                    cp = cp << 6 | (static_cast<unsigned char>(a_utf8[pos++]) & 0x3F);
+                }
+                if (extra && (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))) {
+                    cp = kReplacement;
+                }
+                if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+                    out.push_back(static_cast<wchar_t>(0xD800 + ((cp - 0x10000) >> 10)));
+                    out.push_back(static_cast<wchar_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+                } else {
+                    out.push_back(static_cast<wchar_t>(cp));
+                }
+            }
+            return out;
+        }
+
+        std::string WideToUtf8(const std::wstring_view a_wide) {
+            std::string out;
+            for (std::size_t i = 0; i < a_wide.size(); ++i) {
+                auto cp = static_cast<char32_t>(static_cast<std::make_unsigned_t<wchar_t>>(a_wide[i]));
+                if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDBFF && i + 1 < a_wide.size() &&
+                    a_wide[i + 1] >= 0xDC00 && a_wide[i + 1] <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<char32_t>(a_wide[++i]) - 0xDC00);
+                }
+                if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+                    cp = kReplacement;
+                }
+                if (cp < 0x80) {
+                    out.push_back(static_cast<char>(cp));
+                } else if (cp < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | cp >> 6));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                } else if (cp < 0x10000) {
+                    out.push_back(static_cast<char>(0xE0 | cp >> 12));
+                    out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xF0 | cp >> 18));
+                    out.push_back(static_cast<char>(0x80 | (cp >> 12 & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+            }
+            return out;
+        }
+    }
+
+    constexpr std::array<std::pair<Text::Kernel, const char*>, 3> kTextKernels{
+        {{Text::Kernel::kScalar, "scalar"}, {Text::Kernel::kSse2, "sse2"}, {Text::Kernel::kAvx2, "avx2"}}};
+
+    // Mostly ASCII runs, which decide which kernel path runs, broken up by valid and malformed sequences
+    std::string RandomUtf8(std::mt19937_64& a_rng) {
+        static constexpr std::array<std::string_view, 12> kSequences{
+            "\xC3\xA9",          "\xD0\x96",         "\xE2\x82\xAC", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80",
+            "\xF4\x8F\xBF\xBF",  "\x80",             "\xC3",         "\xE2\x82",     "\xC0\x80",
+            "\xED\xA0\x80",      "\xF4\x90\x80\x80"};
+        const auto length = a_rng() % 300;
+        std::string out;
+        while (out.size() < length) {
+            if (a_rng() % 4) {
+                for (auto run = a_rng() % 48; run && out.size() < length; --run) {
+                    out.push_back(static_cast<char>(a_rng() % 0x80));
+                }
+            } else if (a_rng() % 4) {
+                out.append(kSequences[a_rng() % kSequences.size()]);
+            } else {
+                out.push_back(static_cast<char>(0x80 + a_rng() % 0x80));
+            }
+        }
+        return out;
+    }
+
+    // Without NULs so the const wchar_t* overload sees the whole string
+    std::wstring RandomWide(std::mt19937_64& a_rng) {
+        const auto length = a_rng() % 300;
+        std::wstring out;
+        while (out.size() < length) {
+            if (a_rng() % 4) {
+                for (auto run = a_rng() % 48; run && out.size() < length; --run) {
+                    out.push_back(static_cast<wchar_t>(1 + a_rng() % 0x7F));
+                }
+                continue;
+            }
+            switch (a_rng() % 6) {
+            case 0:
+                out.push_back(static_cast<wchar_t>(0x80 + a_rng() % 0x780));
+                break;
+            case 1:
+                out.push_back(static_cast<wchar_t>(0x800 + a_rng() % 0xD000));
+                break;
+            case 2:
+                // Lone surrogate
+                out.push_back(static_cast<wchar_t>(0xD800 + a_rng() % 0x800));
+                break;
+            case 3:
+                out.append(Reference::Utf8ToWide("\xF0\x9F\x98\x80"));
+                break;
+            case 4:
+                out.push_back(static_cast<wchar_t>(0xE000 + a_rng() % 0x2000));
+                break;
+            default:
+                // Beyond Unicode where wchar_t is 32 bits, including negative values; a BMP character otherwise
+                out.push_back(static_cast<wchar_t>(sizeof(wchar_t) == 2 ? 0xFFFD : 0x110000 + a_rng() % 0x7FFFFFFF));
+                break;
+            }
+        }
+        return out;
+    }
+
+    // Converts every input with the given kernel and compares with the reference; returns the number of mismatches
+    std::size_t FuzzTextKernel(const std::vector<std::string>& a_utf8, const std::vector<std::wstring>& a_wide) {
+        std::size_t mismatches = 0;
+        const auto report = [&](const char* a_what, const std::size_t a_input) {
+            if (mismatches++ < 5) {
+                std::printf("    %s differs from the reference for input %zu\n", a_what, a_input);
+            }
+        };
+        for (std::size_t i = 0; i < a_utf8.size(); ++i) {
+            const auto expected = Reference::Utf8ToWide(a_utf8[i]);
+            if (Text::Utf8ToWide(a_utf8[i]) != expected) {
+                report("Utf8ToWide", i);
+            }
+            const Text::WideBuffer prefixed(a_utf8[i], L"$");
+            if (prefixed.view() != L"$" + expected || prefixed.c_str()[prefixed.view().size()] != L'\0') {
+                report("WideBuffer", i);
+            }
+        }
+        for (std::size_t i = 0; i < a_wide.size(); ++i) {
+            const auto expected = Reference::WideToUtf8(a_wide[i]);
+            if (Text::WideToUtf8(std::wstring_view(a_wide[i])) != expected) {
+                report("WideToUtf8", i);
+            }
+            if (Text::WideToUtf8(a_wide[i].c_str()) != expected) {
+                report("WideToUtf8 (NUL-terminated)", i);
+            }
+            // Nested buffers must not share storage
+            const Text::Utf8Buffer outer(a_wide[i]);
+            {
+                const Text::Utf8Buffer inner(a_wide[(i + 1) % a_wide.size()]);
+                if (inner.view() != Reference::WideToUtf8(a_wide[(i + 1) % a_wide.size()])) {
+                    report("nested Utf8Buffer", i);
+                }
+            }
+            if (outer.view() != expected) {
+                report("Utf8Buffer", i);
+            }
+        }
+        return mismatches;
+    }
+
+    // MB of UTF-8 converted per second by a_convert, run over a_inputs until about 64 MB went through
+    template <class Input, class Convert>
+    double TextThroughput(const std::vector<Input>& a_inputs, const std::size_t a_utf8Bytes, Convert&& a_convert) {
+        constexpr std::size_t kTargetBytes = 64 << 20;
+        const auto rounds = std::max<std::size_t>(kTargetBytes / std::max<std::size_t>(a_utf8Bytes, 1), 1);
+        std::size_t sink = 0;
+        const auto start = Clock::now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (const auto& input : a_inputs) {
+                sink += a_convert(input);
+            }
+        }
+        const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (sink == 0) {
+            std::printf("(nothing converted)\n");
+        }
+        return static_cast<double>(a_utf8Bytes * rounds) / seconds / 1e6;
+    }
+
+    bool RunTextBench() {
+        const auto initial = Text::ActiveKernel();
+
+        std::mt19937_64 rng(11);
+        constexpr std::size_t kFuzzInputs = 20'000;
+        std::vector<std::string> fuzzUtf8;
+        std::vector<std::wstring> fuzzWide;
+        for (std::size_t i = 0; i < kFuzzInputs; ++i) {
+            fuzzUtf8.push_back(RandomUtf8(rng));
+            fuzzWide.push_back(RandomWide(rng));
+        }
+
+        // Translation keys, long ASCII strings and Cyrillic text with ASCII punctuation
+        struct Sample {
+            const char* name;
+            std::vector<std::string> utf8;
+            std::vector<std::wstring> wide;
+            std::size_t bytes{0};
+        };
+        std::array<Sample, 3> samples{{{"keys"}, {"ascii text"}, {"mixed text"}}};
+        for (std::size_t i = 0; i < 4096; ++i) {
+            samples[0].utf8.push_back(fmt::format("DTFPack{:02}_Quest_Objective_{:06}", i % 64, i));
+        }
+        for (std::size_t i = 0; i < 64; ++i) {
+            std::string ascii;
+            std::string mixed;
+            while (ascii.size() < 1024) {
+                ascii += fmt::format("The courier found {} septims near Whiterun. ", i * 7 + ascii.size());
+                mixed += fmt::format("\xD0\x9A\xD1\x83\xD1\x80\xD1\x8C\xD0\xB5\xD1\x80 {}: ", i + mixed.size());
+                mixed += "\xD0\x92\xD0\xB0\xD0\xB9\xD1\x82\xD1\x80\xD0\xB0\xD0\xBD, ";
+            }
+            samples[1].utf8.push_back(std::move(ascii));
+            samples[2].utf8.push_back(std::move(mixed));
+        }
+        for (auto& sample : samples) {
+            for (const auto& utf8 : sample.utf8) {
+                sample.wide.push_back(Reference::Utf8ToWide(utf8));
+                sample.bytes += utf8.size();
+            }
+        }
+
+        bool ok = true;
+        std::printf("text: %zu random UTF-8 and %zu random wchar_t strings against the reference\n", fuzzUtf8.size(),
+                    fuzzWide.size());
+        std::vector<std::pair<Text::Kernel, const char*>> kernels;
+        for (const auto& [kernel, name] : kTextKernels) {
+            if (!Text::UseKernel(kernel)) {
+                std::printf("  %-6s not supported here\n", name);
+                continue;
+            }
+            kernels.emplace_back(kernel, name);
+            const auto mismatches = FuzzTextKernel(fuzzUtf8, fuzzWide);
+            std::printf("  %-6s %s\n", name, mismatches ? fmt::format("{} mismatches", mismatches).c_str() : "ok");
+            ok = ok && mismatches == 0;
+        }
+
+        std::printf("  throughput in MB of UTF-8 per second:\n");
+        for (const auto& sample : samples) {
+            auto toWide = fmt::format("reference {:.0f}", TextThroughput(sample.utf8, sample.bytes, [](auto& a_in) {
+                                          return Reference::Utf8ToWide(a_in).size();
+                                      }));
+            auto toUtf8 = fmt::format("reference {:.0f}", TextThroughput(sample.wide, sample.bytes, [](auto& a_in) {
+                                          return Reference::WideToUtf8(a_in).size();
+                                      }));
+            for (const auto& [kernel, name] : kernels) {
+                Text::UseKernel(kernel);
+                toWide += fmt::format("  {} {:.0f}", name, TextThroughput(sample.utf8, sample.bytes, [](auto& a_in) {
+                                          return Text::WideBuffer(a_in).view().size();
+                                      }));
+                toUtf8 += fmt::format("  {} {:.0f}", name, TextThroughput(sample.wide, sample.bytes, [](auto& a_in) {
+                                          return Text::Utf8Buffer(a_in).view().size();
+                                      }));
+            }
+            std::printf("    %-10s to wchar_t: %s\n", sample.name, toWide.c_str());
+            std::printf("    %-10s to UTF-8:   %s\n", "", toUtf8.c_str());
+        }
+        Text::UseKernel(initial);
+        return ok;
+    }
+}
+
+int main(const int a_argc, char** a_argv) {
+    Options options;
+    if (!ParseOptions(a_argc, a_argv, options)) {
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    KeyStream stream;
+    if (!options.traceFile.empty()) {
+        if (!LoadTrace(options, stream)) {
+            std::fprintf(stderr, "No calls in '%s'\n", options.traceFile.c_str());
+            return 1;
+        }
+    } else if (!options.keysFile.empty()) {
+        if (!LoadKeyStream(options, stream)) {
+            std::fprintf(stderr, "No keys in '%s'\n", options.keysFile.c_str());
+            return 1;
+        }
+    } else {
+        SynthesizeKeyStream(options, stream);
+    }
+    FillFrameEnds(options, stream);
+
+    MockHost host(options.papyrusDelayFrames);
+    SetTranslationHost(&host);
+    MockTranslator translator;
+    BuildRegistry(stream, translator);
+
+    // The first pass warms caches and lets Papyrus results arrive, so it is reported but not representative
+    PassResult result;
+    for (std::size_t pass = 0; pass < options.passes; ++pass) {
+        result = {};
+        RunPass(stream, translator, host, result,
+                [](const std::wstring& a_key) { return TranslateKey(a_key.c_str()); });
+        PrintPass("pass", pass, stream, result);
+    }
+    if (options.baseline) {
+        const BaselineLookup baseline(stream);
+        for (std::size_t pass = 0; pass < options.passes; ++pass) {
+            result = {};
+            RunPass(stream, translator, host, result,
+                    [&](const std::wstring& a_key) { return baseline.Translate(a_key); });
+            PrintPass("baseline pass", pass, stream, result);
+        }
+    }
+    if (options.rules) {
+        RunRuleComparison(options, host);
+    }
+    if (options.indexKeys) {
+        RunIndexBench(options);
+    }
+    const bool textOk = !options.text || RunTextBench();
+    const bool configOk = !options.configFiles || RunConfigBench(options);
+    const bool cacheOk = !options.registryCacheKeys || RunRegistryCacheBench(options);
+    const bool batchOk = !options.batchKeys || RunBatchBench(options, host);
+
+    if (options.report) {
+        LogStats();
+        std::printf("%s", Stats::Report().c_str());
+    }
+    // Last, since it replaces the published registry
+    const bool stressOk = !options.stressReaders || RunRegistryStress(options);
+    SetTranslationHost(nullptr);
+    return textOk && configOk && cacheOk && batchOk && stressOk ? 0 : 1;
+}
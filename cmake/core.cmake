@@ -0,0 +1,28 @@
+# Portable translation core: no CommonLibSSE or Windows dependencies, shared by the plugin and the benchmark
+include(${CMAKE_CURRENT_LIST_DIR}/corelist.cmake)
+
+find_package(spdlog CONFIG REQUIRED)
+find_package(Threads REQUIRED)
+
+option(DTF_ENABLE_STATS "Collect translate latency histograms and hot-key statistics" ON)
+
+add_library(DynamicTranslationCore STATIC ${core_headers} ${core_sources})
+target_compile_features(DynamicTranslationCore PUBLIC cxx_std_23)
+target_include_directories(DynamicTranslationCore PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/include)
+target_link_libraries(DynamicTranslationCore PUBLIC spdlog::spdlog Threads::Threads)
+target_compile_definitions(DynamicTranslationCore PUBLIC DTF_ENABLE_STATS=$<BOOL:${DTF_ENABLE_STATS}>)
+
+# The config parser needs RapidJSON, which the plugin always has; a core-only build without it leaves the parser out
+find_path(RAPIDJSON_INCLUDE_DIRS "rapidjson/document.h")
+if(RAPIDJSON_INCLUDE_DIRS)
+  target_sources(DynamicTranslationCore PRIVATE ${core_config_headers} ${core_config_sources})
+  target_include_directories(DynamicTranslationCore PUBLIC ${RAPIDJSON_INCLUDE_DIRS})
+  # libstdc++ runs std::execution::par on TBB when its headers are installed
+  find_package(TBB CONFIG QUIET)
+  if(TBB_FOUND)
+    target_link_libraries(DynamicTranslationCore PUBLIC TBB::tbb)
+  endif()
+elseif(NOT DTF_CORE_ONLY)
+  message(FATAL_ERROR "RapidJSON not found")
+endif()
+target_compile_definitions(DynamicTranslationCore PUBLIC DTF_HAS_CONFIG_PARSER=$<BOOL:${RAPIDJSON_INCLUDE_DIRS}>)
@@ -0,0 +1,41 @@
+set(core_headers ${core_headers}
+	include/Core/Common.h
+	include/Core/CoreSettings.h
+	include/Core/Provider.h
+	include/Core/Text.h
+	include/Core/StringArena.h
+	include/Core/KeyIndex.h
+	include/Core/ProviderRegistry.h
+	include/Core/ResultCache.h
+	include/Core/NativeBatch.h
+	include/Core/Stats.h
+	include/Core/Translator.h
+	include/Core/Trace.h
+	include/Core/Async.h
+	include/Core/CircuitBreaker.h
+	include/Core/LazyProvider.h
+	include/Core/Rules.h
+	include/Core/RegistryCache.h
+	include/DynamicTranslationAPI.h
+)
+set(core_sources ${core_sources}
+	src/Core/Text.cpp
+	src/Core/KeyIndex.cpp
+	src/Core/ProviderRegistry.cpp
+	src/Core/ResultCache.cpp
+	src/Core/NativeBatch.cpp
+	src/Core/Stats.cpp
+	src/Core/Translator.cpp
+	src/Core/Trace.cpp
+	src/Core/Async.cpp
+	src/Core/CircuitBreaker.cpp
+	src/Core/Rules.cpp
+	src/Core/RegistryCache.cpp
+)
+# Needs RapidJSON; see core.cmake
+set(core_config_headers ${core_config_headers}
+	include/Core/ConfigParser.h
+)
+set(core_config_sources ${core_config_sources}
+	src/Core/ConfigParser.cpp
+)
@@ -7,4 +7,6 @@ set(headers ${headers}
 	include/Hooks.h
 	include/DynamicTranslationSE.h
 	include/ConfigLoader.h
+	include/Serialization.h
+	include/RuleOperands.h
 )
@@ -6,4 +6,6 @@ set(sources ${sources}
 	src/Hooks.cpp
 	src/DynamicTranslationSE.cpp
 	src/ConfigLoader.cpp
+	src/Serialization.cpp
+	src/RuleOperands.cpp
 )
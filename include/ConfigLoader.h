@@ -1,33 +1,55 @@
 #pragma once
 #include <unordered_map>
-#include <rapidjson/document.h>
-#include "boost/pfr/core.hpp"
-#include "CLibUtilsQTR/PresetHelpers/Config.hpp"
 #include "DynamicTranslationSE.h"
+#include "Core/Async.h"
+#include "Core/CircuitBreaker.h"
+#include "Core/ConfigParser.h"
+#include "Core/KeyIndex.h"
+#include "Core/LazyProvider.h"
+#include "Core/Rules.h"
+#include "Core/NativeBatch.h"
+#include "Core/RegistryCache.h"
 
 namespace DynamicTranslationSE {
-    struct ConfigEntryBlock {
-        Presets::Field<std::vector<std::string>, rapidjson::Value> strings{"strings"};
-        Presets::Field<std::string, rapidjson::Value> dll{"skse"};
-        Presets::Field<std::string, rapidjson::Value> papyrus{"papyrus"};
-
-        void load(rapidjson::Value& a_block) {
-            boost::pfr::for_each_field(*this, [&](auto& field) {
-                field.load(a_block);
-            });
-        }
-    };
-
     class ConfigLoader {
     public:
+        // Files are parsed in parallel and merged in filename order; a key registered by a later file overrides the
+        // same key from an earlier one. The merged result is cached in a binary image that skips parsing on the
+        // next launch if no config file changed.
         static void Load();
 
+        // Binds every provider whose DLL loading was deferred, on a background thread
+        static void Prewarm();
+
     private:
         static inline std::unordered_map<std::string, HMODULE> dllCache;
         static inline std::mutex dllCacheMutex;
+        static inline std::unordered_map<std::string, std::shared_ptr<NativeBatchGroup>> batchGroups;
+        static inline std::unordered_map<std::string, std::shared_ptr<AsyncQueue>> asyncQueues;
+        static inline std::unordered_map<std::string, std::shared_ptr<CircuitBreaker>> breakers;
+        static inline std::vector<std::shared_ptr<LazyProvider>> lazyProviders;  // not prewarmed yet
+
+        // Entries whose unbound provider and DLL settings are equal share one LazyProvider, and so one slot of the
+        // KeyIndex provider table
+        struct LazyBinding {
+            Provider unbound;
+            bool memoize;
+            bool async;
+            std::uint32_t asyncQueueLimit;
+            std::shared_ptr<LazyProvider> lazy;
+        };
+        static inline std::unordered_map<std::string, std::vector<LazyBinding>> lazyBindings;  // by DLL name
 
         static HMODULE GetOrLoadDLL(const std::string& dllName);
         static DynamicTranslationFunc ResolveDLLFunction(HMODULE hmod, const std::string& funcName);
-        static void ProcessConfigEntry(const ConfigEntryBlock& entry, const std::string& filePath);
+        static std::shared_ptr<NativeBatchGroup> GetOrCreateBatchGroup(HMODULE hmod, const std::string& dllName);
+        static std::shared_ptr<AsyncQueue> GetOrCreateAsyncQueue(const std::string& dllName, std::uint32_t limit);
+        static std::shared_ptr<CircuitBreaker> GetOrCreateBreaker(const std::string& name);
+        static std::shared_ptr<LazyProvider> GetOrCreateLazyProvider(const EntrySpec& spec, const Provider& unbound);
+        // Loads the entry's DLL and fills in its functions; false if it provides none
+        static bool BindDLL(const EntrySpec& spec, Provider& prov);
+        static std::shared_ptr<const Rules::RuleSet> CompileRules(const EntrySpec& spec);
+        static std::optional<Provider> ResolveEntry(const EntrySpec& spec);
+        static KeyIndex::Source ResolveRegistry(const RegistrySpec& spec);
     };
 }
\ No newline at end of file
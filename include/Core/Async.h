@@ -0,0 +1,95 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include "Core/Common.h"
+
+namespace DynamicTranslationSE {
+    // Shared by every key served by one async provider DLL; bounds how many of its requests may wait at once
+    class AsyncQueue {
+    public:
+        AsyncQueue(std::string a_name, const std::uint32_t a_limit) : name(std::move(a_name)), limit(a_limit) {}
+
+        [[nodiscard]] const std::string& Name() const noexcept { return name; }
+        [[nodiscard]] std::uint32_t Limit() const noexcept { return limit; }
+
+    private:
+        friend class AsyncPool;
+
+        std::string name;
+        std::uint32_t limit;
+        std::uint32_t queued{0};  // guarded by the pool mutex
+    };
+
+    // Bounded worker pool for provider calls that must not run inside the Scaleform translate call.
+    // A key is busy from submission until its job ran, or, when the provider answered "pending", until the provider
+    // delivers or the pending request times out; busy keys are never submitted twice.
+    // CancelAll drops every job that has not started yet and forgets pending requests.
+    class AsyncPool {
+    public:
+        using Job = std::function<void()>;
+
+        struct PendingRequest {
+            std::chrono::milliseconds ttl{};
+            std::uint64_t generation{};
+        };
+
+        struct Counters {
+            std::uint64_t submitted{};
+            std::uint64_t completed{};
+            std::uint64_t rejected{};  // provider queue full
+            std::uint64_t cancelled{};
+        };
+
+        static AsyncPool& GetSingleton();
+
+        AsyncPool(const AsyncPool&) = delete;
+        AsyncPool& operator=(const AsyncPool&) = delete;
+
+        // Queues a_job unless a_key is busy or a_queue is at its limit. Workers start on the first submission.
+        bool Submit(AsyncQueue& a_queue, const std::string& a_key, Job a_job);
+
+        // Called from a job (or a batch fetch) whose provider will deliver a_key later
+        void MarkPending(const std::string& a_key, std::chrono::milliseconds a_ttl, std::uint64_t a_generation);
+        // Removes and returns the pending request for a_key, if it is still wanted
+        std::optional<PendingRequest> TakePending(std::string_view a_key);
+
+        [[nodiscard]] bool IsBusy(std::string_view a_key) const;
+
+        void CancelAll();
+        // Stops and joins the workers; queued jobs are dropped
+        void Shutdown();
+
+        [[nodiscard]] Counters GetCounters() const;
+
+    private:
+        struct Busy {
+            std::chrono::steady_clock::time_point since{};
+            std::uint64_t epoch{};
+            bool pending{false};
+            PendingRequest request{};
+        };
+
+        struct Task {
+            AsyncQueue* queue;
+            std::string key;
+            std::uint64_t epoch;
+            Job job;
+        };
+
+        AsyncPool() = default;
+        ~AsyncPool();
+
+        void WorkerLoop(std::stop_token a_stop);
+        // Requires mutex. Entries of earlier epochs and pending requests that timed out do not count.
+        [[nodiscard]] const Busy* FindBusy(std::string_view a_key) const;
+
+        mutable std::mutex mutex;
+        std::condition_variable_any wake;
+        std::deque<Task> tasks;
+        std::unordered_map<std::string, Busy, StringHash, std::equal_to<>> busy;
+        std::vector<std::jthread> workers;
+        std::uint64_t epoch{0};
+        Counters counters;
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/Common.h"
+
+namespace DynamicTranslationSE {
+    // Health of one provider DLL or script, shared by every entry that names it.
+    // Calls that overrun their budget or fail count against the provider; after kBreakerTripOverruns in a row it
+    // trips and is skipped (callers serve cached text or the vanilla translation) for a backoff that doubles on every
+    // trip that follows a failed probe. Once the backoff ran out a single probe call is let through: a good call
+    // closes the breaker, a bad one trips it again. A probe that never reports back, e.g. a Papyrus call lost to a
+    // game load, stops blocking the next one after kBreakerProbeTimeout.
+    class CircuitBreaker {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit CircuitBreaker(std::string a_name) : name(std::move(a_name)) {}
+
+        // False while tripped. Closed breakers cost one atomic load.
+        [[nodiscard]] bool Allow();
+        // Reports a call that was let through by Allow
+        void Report(Clock::duration a_elapsed, Clock::duration a_budget);
+        void Fail(std::string_view a_reason);
+
+        [[nodiscard]] const std::string& Name() const noexcept { return name; }
+        [[nodiscard]] bool IsTripped() const noexcept { return openUntil.load(std::memory_order_acquire) != 0; }
+        [[nodiscard]] std::uint64_t Trips() const noexcept { return trips.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t Skipped() const noexcept { return skipped.load(std::memory_order_relaxed); }
+
+    private:
+        void Strike(std::string_view a_reason);
+
+        std::string name;
+
+        // Clock ticks until which calls are skipped; 0 while closed
+        std::atomic<Clock::rep> openUntil{0};
+        // Clock ticks until which the probe in flight blocks other calls; 0 while there is none
+        std::atomic<Clock::rep> probeUntil{0};
+        std::atomic<std::uint32_t> strikes{0};
+        std::atomic<std::uint64_t> trips{0};
+        std::atomic<std::uint64_t> skipped{0};
+
+        std::mutex mutex;
+        Clock::duration backoff{};  // guarded by mutex
+    };
+}
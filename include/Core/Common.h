@@ -0,0 +1,36 @@
+#pragma once
+
+// Shared prelude of the translation core. The core builds without CommonLibSSE or Windows headers, so it cannot lean
+// on PCH.h; it includes what it uses here and logs through spdlog directly (the plugin installs the default logger).
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#ifndef _WIN32
+    #define __cdecl
+#endif
+
+namespace DynamicTranslationSE {
+    // Transparent hash for string-keyed maps, so lookups by std::string_view do not build a std::string
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(const std::string_view a_str) const noexcept {
+            return std::hash<std::string_view>{}(a_str);
+        }
+    };
+}
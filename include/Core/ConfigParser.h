@@ -0,0 +1,34 @@
+#pragma once
+#include "Core/RegistryCache.h"
+
+namespace DynamicTranslationSE {
+    // One config file, parsed but not merged yet
+    struct ConfigFile {
+        struct Entry {
+            EntrySpec spec;
+            std::vector<std::string> strings;
+        };
+
+        std::filesystem::path path;
+        std::string filePath;
+        std::vector<Entry> entries;
+    };
+
+    // Reading, parsing and merging of the JSON configs. Free of game lookups, so it runs on worker threads and in the
+    // benchmark; forms and DLLs are resolved by the plugin afterwards.
+    class ConfigParser {
+    public:
+        // Reads a_file.path in one shot and parses it in place. Errors are logged and leave a_file.entries empty.
+        static void ParseFile(ConfigFile& a_file);
+        // Parses every file on the standard parallel algorithm pool
+        static void ParseFiles(std::vector<ConfigFile>& a_files);
+        // Merges the files in order; a key registered by a later file overrides the same key from an earlier one
+        static RegistrySpec Merge(const std::vector<ConfigFile>& a_files);
+
+    private:
+        using KeyOrigins = std::unordered_map<std::string, std::string_view>;
+
+        static void CollectEntry(const ConfigFile::Entry& a_entry, const std::string& a_filePath, RegistrySpec& a_spec,
+                                 KeyOrigins& a_origins);
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/Common.h"
+
+// Tunables of the translation core; game-side settings live in Settings.h
+namespace DynamicTranslationFrameworkSE {
+    // Upper bound on Papyrus translation requests queued in the VM at once
+    constexpr std::uint32_t kMaxConcurrentPapyrusDispatches = 32;
+    // A dispatch that has not completed after this long no longer blocks new ones for its key
+    constexpr std::chrono::milliseconds kPapyrusDispatchTimeout{5000};
+    // Memory budget for cached Papyrus translation results
+    constexpr std::size_t kPapyrusResultCacheBytes = 4 * 1024 * 1024;
+    // Memory budget for memoized native provider results
+    constexpr std::size_t kNativeResultCacheBytes = 4 * 1024 * 1024;
+
+    // Papyrus results restored from a save are refreshed spread over this long instead of all on the first frame
+    constexpr std::chrono::milliseconds kRestoredRefreshSpread{3000};
+
+    // Worker threads for providers marked "async"
+    constexpr std::uint32_t kAsyncWorkerThreads = 2;
+    // Requests an async provider may have queued at once unless its entry sets "asyncQueueLimit"
+    constexpr std::uint32_t kDefaultAsyncQueueLimit = 16;
+    // A provider that answered "pending" and has not delivered after this long is asked again
+    constexpr std::chrono::milliseconds kAsyncPendingTimeout{10000};
+
+    // Time a synchronous provider call may take unless its entry sets "budgetUs"
+    constexpr std::chrono::microseconds kDefaultProviderBudget{2000};
+    // Synchronous provider time allowed per frame; once spent, misses serve cached text until the next frame
+    constexpr std::chrono::microseconds kFrameProviderBudget{4000};
+    // Consecutive overruns or failures that trip a provider's circuit breaker
+    constexpr std::uint32_t kBreakerTripOverruns = 3;
+    // A tripped provider is skipped this long, doubling on every failed retry up to the maximum
+    constexpr std::chrono::seconds kBreakerInitialBackoff{1};
+    constexpr std::chrono::seconds kBreakerMaxBackoff{60};
+    // A probe of a tripped provider that has not reported back after this long is written off and another call probes
+    constexpr std::chrono::milliseconds kBreakerProbeTimeout = kPapyrusDispatchTimeout;
+
+    // Translation statistics are rewritten at most once per interval
+    constexpr std::chrono::seconds kStatsDumpInterval{60};
+    constexpr std::size_t kStatsTopKeys = 20;
+
+    // Per-thread trace ring capacity in records (a power of two); records beyond it are dropped until drained
+    constexpr std::size_t kTraceRingRecords = 8192;
+    constexpr std::chrono::milliseconds kTraceFlushInterval{50};
+}
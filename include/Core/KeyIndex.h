@@ -0,0 +1,126 @@
+#pragma once
+#include "Core/Provider.h"
+#include "Core/Stats.h"
+
+namespace DynamicTranslationSE {
+    // Frozen lookup table keyed on the raw UTF-16 key the GFx translator hands us (including the leading '$').
+    // Misses are rejected by a length mask and hash compare without transcoding or allocating.
+    // Keys ending in '*' register a whole key family by prefix; those live in a flattened trie that is walked once
+    // per lookup, so matching costs O(key length) no matter how many patterns are registered.
+    // Each key is one record in a contiguous buffer, its UTF-16 spelling stored right behind the record, so a hit
+    // touches the hash slot and one record. Records hold lengths and offsets rather than views: the UTF-8 keys are
+    // packed into one string, and providers are referred to by position in a deduplicated table, so a record is 24
+    // bytes plus its characters no matter how large a Provider is.
+    class KeyIndex {
+    public:
+        // A key as lookups see it, rebuilt from its record; the views live as long as the snapshot
+        struct Entry {
+            std::wstring_view wideKey;  // "$Key", or the "$Prefix" a family matches
+            std::string_view key;       // "Key" in UTF-8, as passed to providers; families keep the trailing '*'
+            std::uint32_t provider{};   // position in the provider table
+            std::uint32_t id{};         // position in the hit counters
+        };
+
+        // What Build indexes: every key names its provider by position in providers
+        struct Source {
+            std::vector<Provider> providers;
+            std::vector<std::pair<std::string, std::uint32_t>> keys;
+
+            // Position of a provider equal to a_provider, which is appended if there is none yet
+            std::uint32_t Intern(const Provider& a_provider);
+        };
+
+        void Build(Source a_source);
+
+        [[nodiscard]] const Provider& ProviderOf(const Entry& a_entry) const noexcept {
+            return providers[a_entry.provider];
+        }
+
+        // Exact keys only
+        [[nodiscard]] std::optional<Entry> Find(const wchar_t* a_key) const noexcept;
+        // Longest registered prefix pattern matching a_key
+        [[nodiscard]] std::optional<Entry> FindPrefix(const wchar_t* a_key) const noexcept;
+        // Exact key first, then the longest prefix
+        [[nodiscard]] std::optional<Entry> Find(std::string_view a_keyUtf8) const;
+
+        [[nodiscard]] std::size_t size() const noexcept { return entryOffsets.size() + patternOffsets.size(); }
+        [[nodiscard]] std::size_t ProviderCount() const noexcept { return providers.size(); }
+        // Heap held by this snapshot: entries, hash slots, trie, interned keys and the provider table
+        [[nodiscard]] std::size_t MemoryBytes() const noexcept;
+
+        void CountHit([[maybe_unused]] const Entry& a_entry) const noexcept {
+#if DTF_ENABLE_STATS
+            hits[a_entry.id].fetch_add(1, std::memory_order_relaxed);
+#endif
+        }
+
+        // Most requested keys of this snapshot, hottest first
+        [[nodiscard]] std::vector<std::pair<std::string_view, std::uint32_t>> TopKeys(std::size_t a_count) const;
+
+    private:
+        static constexpr std::size_t kMaxKeyLength = 255;
+
+        struct TrieNode {
+            std::uint32_t firstEdge;
+            std::uint32_t edgeCount;
+            std::uint32_t pattern;  // 0 = none, otherwise pattern index + 1
+        };
+
+        // Edges of a node are contiguous and sorted by label
+        struct TrieEdge {
+            wchar_t label;
+            std::uint32_t child;
+        };
+
+        struct Record {
+            std::uint64_t hash;
+            std::uint32_t keyOffset;   // of the UTF-8 key in keyText
+            std::uint32_t provider;
+            std::uint32_t id;
+            std::uint16_t keyLength;   // UTF-8 bytes
+            std::uint16_t wideLength;  // UTF-16 units stored right behind the record
+        };
+
+        static std::uint64_t Hash(const wchar_t* a_key, std::size_t a_len) noexcept;
+        static constexpr std::size_t RecordSize(const std::size_t a_wideLength) noexcept {
+            return (sizeof(Record) + a_wideLength * sizeof(wchar_t) + alignof(Record) - 1) & ~(alignof(Record) - 1);
+        }
+
+        [[nodiscard]] const Record& RecordAt(const std::uint32_t a_offset) const noexcept {
+            return *std::launder(reinterpret_cast<const Record*>(records.data() + a_offset));
+        }
+        [[nodiscard]] static const wchar_t* WideKeyOf(const Record& a_record) noexcept {
+            return reinterpret_cast<const wchar_t*>(&a_record + 1);
+        }
+        [[nodiscard]] Entry EntryAt(const std::uint32_t a_offset) const noexcept {
+            const auto& record = RecordAt(a_offset);
+            return {{WideKeyOf(record), record.wideLength},
+                    {keyText.data() + record.keyOffset, record.keyLength},
+                    record.provider,
+                    record.id};
+        }
+
+        // Appends a record for a_key, spelled a_wideKey on the UTF-16 side, and returns its offset
+        std::uint32_t AddRecord(std::string_view a_key, std::wstring_view a_wideKey, std::uint32_t a_provider);
+        void BuildTrie();
+
+        std::vector<Provider> providers;
+        std::string keyText;  // every UTF-8 key, back to back
+
+        // Records, each followed by the characters of its wide key and padded to the alignment of Record
+        std::vector<std::byte> records;
+        std::vector<std::uint32_t> entryOffsets;  // of every exact key's record, in id order
+        // Open addressing, 0 = empty. Otherwise the upper half of the key's hash over record offset + 1, so probing
+        // past other keys does not touch their records.
+        std::vector<std::uint64_t> slots;
+        std::size_t slotMask{};
+        std::array<std::uint64_t, (kMaxKeyLength + 1) / 64> lengthMask{};
+        std::size_t maxLength{};
+
+        std::vector<std::uint32_t> patternOffsets;  // of every family's record; its ids follow the exact keys'
+        std::vector<TrieNode> trieNodes;
+        std::vector<TrieEdge> trieEdges;
+
+        std::unique_ptr<std::atomic<std::uint32_t>[]> hits;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <functional>
+#include "Core/Provider.h"
+
+namespace DynamicTranslationSE {
+    // A provider whose DLL is loaded the first time one of its keys is translated. The binder runs exactly once, on
+    // whichever thread gets there first; every other caller waits for it and then sees the bound provider.
+    class LazyProvider {
+    public:
+        using Binder = std::function<Provider()>;
+
+        explicit LazyProvider(Binder a_binder) : binder(std::move(a_binder)) {}
+
+        LazyProvider(const LazyProvider&) = delete;
+        LazyProvider& operator=(const LazyProvider&) = delete;
+
+        const Provider& Get() {
+            if (!bound.load(std::memory_order_acquire)) {
+                std::call_once(once, [this] {
+                    provider = binder();
+                    binder = nullptr;
+                    bound.store(true, std::memory_order_release);
+                });
+            }
+            return provider;
+        }
+
+        [[nodiscard]] bool IsBound() const noexcept { return bound.load(std::memory_order_acquire); }
+
+    private:
+        std::once_flag once;
+        std::atomic_bool bound{false};
+        Binder binder;
+        Provider provider;
+    };
+
+    // The provider to call for a_provider, binding it first if it is lazy
+    inline const Provider& Bound(const Provider& a_provider) {
+        return a_provider.lazy ? a_provider.lazy->Get() : a_provider;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Core/Provider.h"
+#include "Core/ResultCache.h"
+
+namespace DynamicTranslationSE {
+    // Shared by every key served by one v2 provider DLL. Keys that missed recently are fetched together, so a menu
+    // showing many keys from the same DLL costs one cross-module call per refresh instead of one per key. Keys that
+    // miss once the DLL was called in a frame are fetched together at the end of it (FlushNativeBatches).
+    class NativeBatchGroup {
+    public:
+        NativeBatchGroup(std::string a_dllName, DynamicTranslationBatchFunc a_func)
+            : dllName(std::move(a_dllName)), func(a_func) {}
+
+        // Fetches a_key for a_prov together with the other hot keys of this DLL and stores every result in a_cache,
+        // each under its own ttl and the generation it is looked up with right now. Returns the result for a_key.
+        // Keys the provider answers as pending are handed to the AsyncPool instead.
+        std::wstring Fetch(std::string_view a_key, ResultCache& a_cache, const Provider& a_prov);
+        // Once this DLL was called in the current frame, further misses are left for FlushDeferred, so a frame
+        // opening a menu costs two calls rather than one per key. False if the caller has to Fetch a_key now.
+        bool Defer(std::string_view a_key, const Provider& a_prov);
+        // Fetches the deferred keys like Fetch; true if any result was stored
+        bool FlushDeferred(ResultCache& a_cache);
+
+        // Keys per call; more keys are spread over several calls
+        static constexpr std::uint32_t kMaxBatchKeys = 256;
+
+    private:
+        static constexpr std::uint32_t kInitialArena = 16 * 1024;
+        static constexpr std::uint32_t kMaxArena = 1024 * 1024;
+        // A key stays in the batch for this many frames after it last missed the cache
+        static constexpr std::uint64_t kHotFrames = 60;
+
+        bool Call(std::uint32_t a_count);
+        // Calls the DLL for batchKeys and stores the results; a_first receives the one of the first key
+        bool CallAndStore(ResultCache& a_cache, std::wstring& a_first);
+
+        std::string dllName;
+        DynamicTranslationBatchFunc func;
+
+        std::mutex mutex;
+        // The last miss of a hot key and the settings of the entry it came from, which may differ between the
+        // entries of one DLL. Its generation is taken anew for every call, as a non-memoized one changes per frame.
+        struct HotKey {
+            std::uint64_t frame{};
+            std::chrono::milliseconds ttl{};
+            DynamicTranslationGenerationFunc providerGeneration{};
+            bool memoize{false};
+            bool deferred{false};  // waits for FlushDeferred
+        };
+        using HotKeys = std::unordered_map<std::string, HotKey, StringHash, std::equal_to<>>;
+
+        HotKeys hotKeys;
+        std::uint64_t lastCallFrame{~0ull};
+        std::vector<HotKeys::value_type*> batchKeys;
+        std::vector<DTFKey> keys;
+        std::vector<std::uint64_t> generations;  // parallel to keys
+        std::vector<DTFResult> results;
+        std::vector<wchar_t> arena = std::vector<wchar_t>(kInitialArena);
+        std::uint32_t arenaUsed{0};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "Core/Common.h"
+#include "Core/CoreSettings.h"
+#include "DynamicTranslationAPI.h"
+
+namespace DynamicTranslationSE {
+    using DynamicTranslationFunc = const wchar_t*(__cdecl*)(std::string_view);
+    // Optional provider export: bumped by the provider whenever any of its translations may have changed
+    using DynamicTranslationGenerationFunc = std::uint64_t(__cdecl*)();
+    class NativeBatchGroup;
+    class AsyncQueue;
+    class CircuitBreaker;
+    class LazyProvider;
+    namespace Rules {
+        class RuleSet;
+    }
+    using PapyrusScriptID = std::pair<std::uint32_t, std::string>; // formID, editorID
+
+    // When a Papyrus-backed key is re-dispatched while a result is already cached
+    enum class RefreshPolicy : std::uint8_t {
+        kAlways,   // on every translate, at most one call in flight per key
+        kInterval, // at most once per refreshInterval
+        kEvent     // only while nothing is cached; the script pushes updates via DynamicTranslateV1
+    };
+
+    struct Provider {
+        DynamicTranslationFunc native{};
+        DynamicTranslationGenerationFunc generation{};
+        std::shared_ptr<NativeBatchGroup> batch{};  // set when the DLL exports the v2 batch ABI
+        std::shared_ptr<AsyncQueue> async{};        // set when the entry asks for calls off the UI thread
+        bool memoize{false};
+        PapyrusScriptID scriptID{};
+        RefreshPolicy refresh{RefreshPolicy::kAlways};
+        std::chrono::milliseconds refreshInterval{};
+        std::chrono::milliseconds ttl{}; // lifetime of cached results, 0 = until evicted
+        std::shared_ptr<CircuitBreaker> breaker{};  // shared by every entry naming the same DLL or script
+        // Per synchronous call; overruns count against the breaker
+        std::chrono::microseconds budget{DynamicTranslationFrameworkSE::kDefaultProviderBudget};
+        std::uint16_t statsId{};
+        std::shared_ptr<LazyProvider> lazy{};  // set while the DLL is not loaded yet; see Bound()
+        std::shared_ptr<const Rules::RuleSet> rules{};  // evaluated first; the other providers serve unmatched calls
+
+        // Keys of equal providers share one slot of the KeyIndex provider table
+        bool operator==(const Provider&) const = default;
+    };
+
+    // How a translate call was served, as recorded in traces
+    enum class ProviderKind : std::uint8_t {
+        kNone,            // no provider, the vanilla translation stands
+        kNative,
+        kNativeMemoized,
+        kBatch,
+        kPapyrus,
+        kUnregistered,    // a script-pushed result for a key without a config entry
+        kRules,
+        kTotal
+    };
+
+    inline ProviderKind KindOf(const Provider& a_provider) {
+        if (a_provider.rules) {
+            return ProviderKind::kRules;
+        }
+        if (a_provider.batch) {
+            return ProviderKind::kBatch;
+        }
+        if (a_provider.native) {
+            return a_provider.memoize ? ProviderKind::kNativeMemoized : ProviderKind::kNative;
+        }
+        return a_provider.scriptID.second.empty() ? ProviderKind::kUnregistered : ProviderKind::kPapyrus;
+    }
+}
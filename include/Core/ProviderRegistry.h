@@ -0,0 +1,35 @@
+#pragma once
+#include "Core/KeyIndex.h"
+
+namespace DynamicTranslationSE {
+    // Publishes immutable KeyIndex snapshots through a single atomic pointer.
+    // Readers pin the current snapshot with a ReadGuard and never take a lock; Publish swaps in a new snapshot and
+    // frees the previous one once every reader that could still see it has left (two-slot epoch RCU).
+    class ProviderRegistry {
+    public:
+        class ReadGuard {
+        public:
+            ReadGuard() noexcept;
+            ~ReadGuard();
+
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+
+            const KeyIndex* operator->() const noexcept { return index; }
+            const KeyIndex& operator*() const noexcept { return *index; }
+
+        private:
+            std::size_t slot;
+            const KeyIndex* index;
+        };
+
+        static void Publish(std::unique_ptr<KeyIndex> a_index);
+
+    private:
+        static inline const KeyIndex emptyIndex{};
+        static inline std::atomic<const KeyIndex*> current{&emptyIndex};
+        static inline std::atomic<std::uint64_t> epoch{0};
+        static inline std::array<std::atomic<std::uint32_t>, 2> readers{};
+        static inline std::mutex writerMutex;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include "Core/Provider.h"
+
+namespace DynamicTranslationSE {
+    // A config entry as read from JSON, before its form and DLL are resolved
+    struct EntrySpec {
+        std::string dll;
+        std::string papyrus;
+        RefreshPolicy refresh{RefreshPolicy::kAlways};
+        std::uint32_t refreshIntervalMs{};
+        std::uint32_t ttlMs{};
+        bool memoize{false};
+        bool async{false};
+        std::uint32_t asyncQueueLimit{};  // 0 = kDefaultAsyncQueueLimit
+        std::uint32_t budgetUs{};         // 0 = kDefaultProviderBudget
+        std::string rules;                // JSON array of rules, compiled when the entry is resolved
+
+        bool operator==(const EntrySpec&) const = default;
+    };
+
+    // Merged contents of every config file: the entries, and the entry each key resolved to
+    struct RegistrySpec {
+        std::vector<EntrySpec> entries;
+        std::unordered_map<std::string, std::uint32_t> keys;
+
+        bool operator==(const RegistrySpec&) const = default;
+    };
+
+    struct ManifestEntry {
+        std::string name;
+        std::uint64_t size{};
+        std::int64_t mtime{};
+
+        bool operator==(const ManifestEntry&) const = default;
+    };
+
+    // Config files a RegistrySpec was built from, in merge order
+    using Manifest = std::vector<ManifestEntry>;
+
+    // Flat binary image of a RegistrySpec stored next to the configs. Fixed-size records refer into one string
+    // blob, so the image is read with a handful of bulk reads into vectors and no parsing. It is not memory-mapped:
+    // every string is copied into the RegistrySpec anyway, so a mapping would only save the bulk read.
+    class RegistryCache {
+    public:
+        // Fails (and leaves a_spec untouched) when the image is missing, corrupt or built from different files
+        static bool Read(const std::filesystem::path& a_path, const Manifest& a_manifest, RegistrySpec& a_spec);
+        static void Write(const std::filesystem::path& a_path, const Manifest& a_manifest, const RegistrySpec& a_spec);
+
+    private:
+        static constexpr std::uint32_t kMagic = 0x52465444;  // "DTFR"
+        static constexpr std::uint32_t kVersion = 4;
+
+        struct Header {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t blobSize;
+            std::uint32_t fileCount;
+            std::uint32_t entryCount;
+            std::uint32_t keyCount;
+        };
+
+        struct StringRef {
+            std::uint32_t offset;
+            std::uint32_t size;
+        };
+
+        struct FileRecord {
+            StringRef name;
+            std::uint64_t size;
+            std::int64_t mtime;
+        };
+
+        struct EntryRecord {
+            StringRef dll;
+            StringRef papyrus;
+            StringRef rules;
+            std::uint32_t refreshIntervalMs;
+            std::uint32_t ttlMs;
+            std::uint32_t asyncQueueLimit;
+            std::uint32_t budgetUs;
+            std::uint8_t refresh;
+            std::uint8_t memoize;
+            std::uint8_t async;
+            std::uint8_t padding;
+        };
+
+        struct KeyRecord {
+            StringRef key;
+            std::uint32_t entry;
+        };
+    };
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include "Core/Common.h"
+#include "Core/StringArena.h"
+
+namespace DynamicTranslationSE {
+    // Translation results keyed by UTF-8 key, stored already encoded as UTF-16 so hits can go straight to SetResult.
+    // Memory is bounded by a byte budget; entries are evicted in CLOCK (second chance) order and may carry a TTL.
+    // Keys and values live in arenas rather than in a heap allocation each. Replaced and evicted text stays in the
+    // arenas until it outweighs the live text, at which point the live entries are copied into fresh ones.
+    class ResultCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Stats {
+            std::uint64_t hits{};
+            std::uint64_t misses{};
+            std::uint64_t expirations{};
+            std::uint64_t evictions{};
+            std::size_t entries{};
+            std::size_t bytes{};
+            std::size_t arenaBytes{};
+            std::uint64_t compactions{};
+        };
+
+        explicit ResultCache(std::size_t a_byteBudget) : byteBudget(a_byteBudget) {}
+
+        // Copies the cached value into a_out. Expired entries and entries stored under a different generation
+        // count as misses.
+        bool Get(std::string_view a_key, std::wstring& a_out, std::uint64_t a_generation = 0) const;
+        void Put(std::string_view a_key, std::wstring_view a_value, std::chrono::milliseconds a_ttl = {},
+                 std::uint64_t a_generation = 0);
+        // Copies whatever value is stored for a_key, ignoring expiry and generation. Not counted in the stats;
+        // serves stale text while a fresh result is computed in the background.
+        bool GetLastKnown(std::string_view a_key, std::wstring& a_out) const;
+        void Erase(std::string_view a_key);
+        void Clear();
+
+        // Calls a_visit(key, value, remaining TTL) for every entry that has not expired, under the shared lock.
+        // The remaining TTL is zero for entries that never expire; the views are only valid during the call.
+        template <class Visit>
+        void ForEach(Visit&& a_visit) const {
+            const auto now = Clock::now();
+            std::shared_lock lock(mutex);
+            for (const auto& slot : slots) {
+                if (!slot.used || slot.expires <= now) {
+                    continue;
+                }
+                const auto remaining = slot.expires == Clock::time_point::max() ? Clock::duration::zero()
+                                                                                 : slot.expires - now;
+                a_visit(slot.key, slot.value, remaining);
+            }
+        }
+
+        [[nodiscard]] Stats GetStats() const;
+        void LogStats(std::string_view a_name) const;
+
+    private:
+        struct Slot {
+            std::string_view key;     // in keyArena
+            std::wstring_view value;  // in valueArena
+            Clock::time_point expires{Clock::time_point::max()};
+            std::uint64_t generation{};
+            mutable std::atomic_bool referenced{false};
+            bool used{false};
+        };
+
+        // Rough per-entry bookkeeping cost on top of the key and value payloads
+        static constexpr std::size_t kEntryOverhead = sizeof(Slot) + 32;
+
+        static std::size_t TextBytes(const std::string_view a_key, const std::wstring_view a_value) {
+            return a_key.size() + a_value.size() * sizeof(wchar_t);
+        }
+        static std::size_t EntryBytes(const std::string_view a_key, const std::wstring_view a_value) {
+            return TextBytes(a_key, a_value) + kEntryOverhead;
+        }
+
+        // Evicts one entry other than the one at a_keep; the caller makes sure there is one
+        void EvictOne(std::size_t a_keep = static_cast<std::size_t>(-1));
+        void Release(std::size_t a_pos);
+        // Copies the live keys and values into fresh arenas once dead text outweighs them
+        void MaybeCompact();
+
+        mutable std::shared_mutex mutex;
+        StringArena keyArena;
+        WideStringArena valueArena;
+        std::size_t deadBytes{0};  // replaced or released text still held by the arenas
+        std::uint64_t compactions{0};
+        std::unordered_map<std::string_view, std::size_t, StringHash, std::equal_to<>> index;
+        std::deque<Slot> slots;
+        std::vector<std::size_t> freeSlots;
+        std::size_t hand{0};
+        std::size_t byteBudget;
+        std::size_t bytes{0};
+
+        mutable std::atomic<std::uint64_t> hits{0};
+        mutable std::atomic<std::uint64_t> misses{0};
+        mutable std::atomic<std::uint64_t> expirations{0};
+        std::uint64_t evictions{0};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include <functional>
+#include "Core/Common.h"
+
+// Declarative providers: a config entry lists rules such as
+//     { "when": ["quest:MQ101 >= 20", "global:GameHour < 12"], "text": "{} hours left", "args": ["global:Timer"] }
+// which are compiled at load time into a flat decision list and evaluated in the translate call without any script.
+namespace DynamicTranslationSE::Rules {
+    // Reads one game value; context and arg are whatever the resolver bound for the operand
+    using ReadFunc = float (*)(const void* a_context, std::uint32_t a_arg);
+
+    struct Operand {
+        ReadFunc read{};
+        const void* context{};
+        std::uint32_t arg{};
+    };
+
+    // Binds an operand reference "kind:name" (e.g. "global:GameHour") to a reader; nothing if it is unknown
+    using OperandResolver = std::function<std::optional<Operand>(std::string_view a_kind, std::string_view a_name)>;
+
+    // One rule as written in a config. Every condition must hold; then each {} in text is replaced by the value of the
+    // next operand in args. A rule without conditions always matches.
+    struct RuleSource {
+        std::vector<std::string> when;
+        std::string text;
+        std::vector<std::string> args;
+    };
+
+    class RuleSet {
+    public:
+        // Distinct operands a rule set may read
+        static constexpr std::size_t kMaxOperands = 16;
+
+        // Logs the first error, naming a_owner, and returns nullptr if a condition, operand or placeholder is invalid
+        static std::shared_ptr<const RuleSet> Compile(const std::vector<RuleSource>& a_rules,
+                                                      const OperandResolver& a_resolve, std::string_view a_owner);
+
+        // Text of the first rule whose conditions hold, or an empty string if none does.
+        // Each operand is read at most once per call.
+        [[nodiscard]] std::wstring Evaluate() const;
+
+        [[nodiscard]] std::size_t RuleCount() const noexcept { return rules.size(); }
+
+    private:
+        enum class Op : std::uint8_t { kEq, kNe, kLt, kLe, kGt, kGe };
+
+        struct Condition {
+            std::uint16_t operand;
+            Op op;
+            float value;
+        };
+
+        // Literal text[offset, offset + size), followed by the value of operand unless it is kNoOperand
+        struct Piece {
+            static constexpr std::uint16_t kNoOperand = 0xFFFF;
+
+            std::uint32_t offset;
+            std::uint32_t size;
+            std::uint16_t operand;
+        };
+
+        struct Rule {
+            std::uint32_t firstCondition;
+            std::uint32_t conditionCount;
+            std::uint32_t firstPiece;
+            std::uint32_t pieceCount;
+        };
+
+        std::optional<std::uint16_t> AddOperand(std::string_view a_reference, const OperandResolver& a_resolve,
+                                                std::string& a_error);
+        bool AddCondition(std::string_view a_condition, const OperandResolver& a_resolve, std::string& a_error);
+        bool AddText(std::string_view a_text, const std::vector<std::string>& a_args, const OperandResolver& a_resolve,
+                     std::string& a_error);
+
+        std::vector<std::string> operandNames;
+        std::vector<Operand> operands;
+        std::vector<Condition> conditions;
+        std::vector<Piece> pieces;
+        std::vector<Rule> rules;
+        std::wstring text;
+    };
+}
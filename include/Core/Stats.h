@@ -0,0 +1,78 @@
+#pragma once
+#include "Core/Common.h"
+
+#ifndef DTF_ENABLE_STATS
+    #define DTF_ENABLE_STATS 1
+#endif
+
+// Always-on timing for the translate path. Every thread writes its own counters and log2-bucketed latency
+// histograms, so recording never contends; readers merge all threads when building a report.
+// Building with DTF_ENABLE_STATS=0 turns every call below into a no-op.
+namespace DynamicTranslationSE::Stats {
+    enum class Metric : std::uint8_t {
+        kHook,               // whole Translate_Hook
+        kOriginalTranslate,  // vanilla GFxTranslator::Translate
+        kPapyrusRoundTrip,   // Papyrus dispatch until the script's result arrives
+        kScriptLockWait,     // waiting for attachedScriptsLock before a script lookup
+        kScriptLookup,       // resolving a provider's script object, attachedScriptsLock held
+        kTotal
+    };
+
+    // Provider ids at or above this share the last slot
+    constexpr std::uint16_t kMaxProviders = 64;
+
+    using Clock = std::chrono::steady_clock;
+
+#if DTF_ENABLE_STATS
+    void Record(Metric a_metric, Clock::duration a_elapsed);
+    void RecordProvider(std::uint16_t a_providerId, Clock::duration a_elapsed);
+
+    // Returns a stable id for a DLL or script name; 0 is reserved for unattributed calls
+    std::uint16_t RegisterProvider(std::string_view a_name);
+
+    // Human-readable dump of all histograms and the hottest keys
+    std::string Report();
+    // Writes Report() to a_path if kStatsDumpInterval has passed since the last dump
+    void MaybeDump(const std::filesystem::path& a_path);
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(const Metric a_metric) : metric(a_metric), start(Clock::now()) {}
+        ~ScopedTimer() { Record(metric, Clock::now() - start); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Metric metric;
+        Clock::time_point start;
+    };
+
+    class ScopedProviderTimer {
+    public:
+        explicit ScopedProviderTimer(const std::uint16_t a_providerId) : providerId(a_providerId), start(Clock::now()) {}
+        ~ScopedProviderTimer() { RecordProvider(providerId, Clock::now() - start); }
+
+        ScopedProviderTimer(const ScopedProviderTimer&) = delete;
+        ScopedProviderTimer& operator=(const ScopedProviderTimer&) = delete;
+
+    private:
+        std::uint16_t providerId;
+        Clock::time_point start;
+    };
+#else
+    inline void Record(Metric, Clock::duration) {}
+    inline void RecordProvider(std::uint16_t, Clock::duration) {}
+    inline std::uint16_t RegisterProvider(std::string_view) { return 0; }
+    inline std::string Report() { return "Statistics are disabled in this build"; }
+    inline void MaybeDump(const std::filesystem::path&) {}
+
+    struct ScopedTimer {
+        explicit ScopedTimer(Metric) {}
+    };
+
+    struct ScopedProviderTimer {
+        explicit ScopedProviderTimer(std::uint16_t) {}
+    };
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include "Core/Common.h"
+
+namespace DynamicTranslationSE {
+    // Append-only string storage. Strings are packed back to back into large blocks that never move, so the views
+    // handed out stay valid until Clear and neighbouring strings share cache lines instead of each owning a heap
+    // allocation. Not synchronized; owners guard it like the rest of their state.
+    template <class Char>
+    class BasicStringArena {
+    public:
+        using View = std::basic_string_view<Char>;
+
+        static constexpr std::size_t kBlockChars = 16 * 1024 / sizeof(Char);
+
+        BasicStringArena() = default;
+        BasicStringArena(BasicStringArena&&) noexcept = default;
+        BasicStringArena& operator=(BasicStringArena&&) noexcept = default;
+
+        // Copy of a_str that lives as long as the arena. Strings longer than a block get a block of their own.
+        View Store(const View a_str) {
+            if (a_str.empty()) {
+                return {};
+            }
+            used += a_str.size();
+            if (a_str.size() >= kBlockChars) {
+                // Leaves the current block open for the strings that follow
+                reserved += a_str.size();
+                const auto out = blocks.emplace_back(std::make_unique_for_overwrite<Char[]>(a_str.size())).get();
+                std::copy(a_str.begin(), a_str.end(), out);
+                return {out, a_str.size()};
+            }
+            if (a_str.size() > free) {
+                reserved += kBlockChars;
+                next = blocks.emplace_back(std::make_unique_for_overwrite<Char[]>(kBlockChars)).get();
+                free = kBlockChars;
+            }
+            const auto out = next;
+            std::copy(a_str.begin(), a_str.end(), out);
+            next += a_str.size();
+            free -= a_str.size();
+            return {out, a_str.size()};
+        }
+
+        void Clear() noexcept {
+            blocks.clear();
+            next = nullptr;
+            free = 0;
+            used = 0;
+            reserved = 0;
+        }
+
+        // Characters handed out by Store, and characters held in blocks
+        [[nodiscard]] std::size_t Used() const noexcept { return used; }
+        [[nodiscard]] std::size_t Reserved() const noexcept { return reserved; }
+        [[nodiscard]] std::size_t MemoryBytes() const noexcept {
+            return reserved * sizeof(Char) + blocks.capacity() * sizeof(blocks[0]);
+        }
+
+    private:
+        std::vector<std::unique_ptr<Char[]>> blocks;
+        Char* next{};
+        std::size_t free{0};
+        std::size_t used{0};
+        std::size_t reserved{0};
+    };
+
+    using StringArena = BasicStringArena<char>;
+    using WideStringArena = BasicStringArena<wchar_t>;
+}
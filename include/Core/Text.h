@@ -0,0 +1,57 @@
+#pragma once
+#include "Core/Common.h"
+
+// UTF-8 <-> wchar_t conversion for the core. wchar_t holds UTF-16 on Windows and UTF-32 elsewhere; both are handled
+// so the core behaves the same in the game and in the Linux benchmark. Invalid input becomes U+FFFD.
+//
+// Conversions are single pass: the output is sized from the input up front and runs of ASCII, which is nearly every
+// key, are copied by the widest SIMD kernel the CPU supports; only other code points are decoded one at a time.
+namespace DynamicTranslationSE::Text {
+    std::wstring Utf8ToWide(std::string_view a_utf8);
+    std::string WideToUtf8(std::wstring_view a_wide);
+    std::string WideToUtf8(const wchar_t* a_wide);
+
+    // Append the converted text to a_out, e.g. a buffer the caller reuses
+    void AppendWide(std::wstring& a_out, std::string_view a_utf8);
+    void AppendUtf8(std::string& a_out, std::wstring_view a_wide);
+
+    // Text converted into a per-thread buffer that is reused from call to call, so converting allocates nothing once
+    // the buffer has grown. Valid until the object goes out of scope; buffers nested on one thread are independent.
+    // Must not live across a coroutine suspension.
+    class WideBuffer {
+    public:
+        explicit WideBuffer(std::string_view a_utf8, std::wstring_view a_prefix = {});
+        ~WideBuffer();
+
+        WideBuffer(const WideBuffer&) = delete;
+        WideBuffer& operator=(const WideBuffer&) = delete;
+
+        [[nodiscard]] const wchar_t* c_str() const noexcept { return text.c_str(); }
+        [[nodiscard]] std::wstring_view view() const noexcept { return text; }
+
+    private:
+        std::wstring& text;
+    };
+
+    class Utf8Buffer {
+    public:
+        explicit Utf8Buffer(std::wstring_view a_wide);
+        ~Utf8Buffer();
+
+        Utf8Buffer(const Utf8Buffer&) = delete;
+        Utf8Buffer& operator=(const Utf8Buffer&) = delete;
+
+        [[nodiscard]] const char* c_str() const noexcept { return text.c_str(); }
+        [[nodiscard]] std::string_view view() const noexcept { return text; }
+
+    private:
+        std::string& text;
+    };
+
+    // Implementations of the ASCII runs. The best one the CPU supports is picked on first use.
+    enum class Kernel : std::uint8_t { kScalar, kSse2, kAvx2 };
+
+    [[nodiscard]] Kernel ActiveKernel() noexcept;
+    // For benchmarks: switches every thread to a_kernel; false, and no change, if the build or CPU lacks it
+    bool UseKernel(Kernel a_kernel) noexcept;
+}
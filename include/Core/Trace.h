@@ -0,0 +1,73 @@
+#pragma once
+#include "Core/Provider.h"
+
+// Optional capture of every translate call. Each thread appends fixed-size records to its own single-producer ring
+// buffer; a writer thread drains the rings into the trace file, so a translating thread never waits on I/O. When a
+// ring is full the record is dropped and counted rather than blocking.
+//
+// File layout: FileHeader, then blocks of either key definitions (id, size, UTF-8 bytes) or CallRecords. Key ids are
+// assigned per thread on first sight, so one key may be defined under several ids.
+namespace DynamicTranslationSE::Trace {
+    constexpr std::uint32_t kMagic = 0x54465444;  // "DTFT"
+    constexpr std::uint32_t kVersion = 1;
+
+    enum RecordFlags : std::uint8_t {
+        kRegistryHit = 1 << 0,  // the key matched a registered key or prefix
+        kTranslated = 1 << 1    // the core replaced the vanilla result
+    };
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+    };
+
+    enum class BlockType : std::uint32_t {
+        kKeys,
+        kRecords
+    };
+
+    struct BlockHeader {
+        BlockType type;
+        std::uint32_t count;
+    };
+
+    struct KeyDefinition {
+        std::uint32_t id;
+        std::uint32_t size;  // followed by size bytes of UTF-8
+    };
+
+    struct CallRecord {
+        std::uint64_t timestampNs;  // since the capture started
+        std::uint32_t keyId;
+        std::uint32_t latencyNs;    // whole translate call, vanilla translation included
+        std::uint16_t thread;       // capture-local thread index
+        ProviderKind provider;
+        std::uint8_t flags;
+        std::uint32_t padding;
+    };
+
+    // A trace loaded back into memory; records are in timestamp order
+    struct Capture {
+        std::unordered_map<std::uint32_t, std::string> keys;
+        std::vector<CallRecord> records;
+    };
+
+    namespace detail {
+        inline std::atomic_bool recording{false};
+    }
+
+    [[nodiscard]] inline bool IsRecording() noexcept {
+        return detail::recording.load(std::memory_order_relaxed);
+    }
+
+    // Fails if a capture is already running or the file cannot be created
+    bool Start(const std::filesystem::path& a_path);
+    // Drains every ring, writes the tail of the trace and closes the file
+    void Stop();
+
+    // a_key is the raw GFx key (any string the UI asks for, not only "$" keys)
+    void Record(const wchar_t* a_key, ProviderKind a_provider, std::uint8_t a_flags,
+                std::chrono::steady_clock::duration a_latency);
+
+    bool Load(const std::filesystem::path& a_path, Capture& a_capture);
+}
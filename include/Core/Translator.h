@@ -0,0 +1,75 @@
+#pragma once
+#include "Core/Provider.h"
+
+namespace DynamicTranslationSE {
+    // What the core needs from its embedding: the game adapter drives it from the UI thread and the Papyrus VM, the
+    // benchmark from mocks.
+    class TranslationHost {
+    public:
+        virtual ~TranslationHost() = default;
+
+        // Monotonic frame counter of the thread that translates
+        [[nodiscard]] virtual std::uint64_t CurrentFrame() = 0;
+        // Starts an asynchronous Papyrus request; the host reports back through CompletePapyrusDispatch
+        virtual void DispatchPapyrus(const PapyrusScriptID& a_script, const std::string& a_key,
+                                     std::chrono::milliseconds a_ttl) = 0;
+        // Called from any thread once an async provider delivered new text; the host re-translates what is on screen
+        virtual void RequestRefresh() = 0;
+    };
+
+    // Must be set before the first translate; the host outlives every call into the core
+    void SetTranslationHost(TranslationHost* a_host);
+
+    struct TranslateOutcome {
+        ProviderKind provider{ProviderKind::kNone};
+        bool registryHit{false};  // the key matched a registered key or prefix
+    };
+
+    // Full translate path for a raw GFx key ("$Key"). Returns an empty string when no provider has a result.
+    std::wstring TranslateKey(const wchar_t* a_key, TranslateOutcome* a_outcome = nullptr);
+
+    std::wstring InvokeProvider(const Provider& prov, std::string_view a_key);
+
+    // Called by the host once a dispatched Papyrus request finished; an empty result leaves the cache untouched
+    void CompletePapyrusDispatch(const std::string& a_key, std::wstring_view a_result, std::chrono::milliseconds a_ttl);
+
+    // Delivery of a key an async provider answered as pending. Ignored when nobody waits for it any more.
+    void CompleteNativeRequest(std::string_view a_key, const wchar_t* a_result);
+    // Called by the host once per frame after its translations: fetches the batch keys that missed after their DLL
+    // had already been called in that frame, in one call per DLL, and requests a refresh once they are cached
+    void FlushNativeBatches();
+    // Drops queued async provider calls and forgets pending requests, e.g. once the menu that wanted them closed
+    void CancelAsyncRequests();
+
+    // Papyrus results are saved with the game so the first frame after a load already shows them.
+    // The snapshot is self-contained; the host stores it as one opaque record tagged with kPapyrusResultsVersion.
+    constexpr std::uint32_t kPapyrusResultsVersion = 1;
+    std::string SavePapyrusResults();
+    // Replaces the cached Papyrus results; false (and an empty cache) if a_data is not a valid snapshot
+    bool LoadPapyrusResults(std::string_view a_data, std::uint32_t a_version);
+    void ClearPapyrusResults();
+    // Forgets dispatch bookkeeping of keys that are neither in flight nor throttled, e.g. once a menu closed, so the
+    // table does not keep every key ever dispatched in a session
+    void PruneDispatchStates();
+
+    // A result pushed by a script, for registered or unregistered keys
+    void PushResult(std::string_view a_key, std::string_view a_valueUtf8);
+
+    std::uint64_t CurrentFrame();
+
+    // Generation a native result for a_key is stored and looked up under right now: InvalidateAll, InvalidateKey
+    // and a_providerGeneration move it, and so does the frame unless a_memoize is set
+    std::uint64_t NativeResultGeneration(std::string_view a_key, bool a_memoize,
+                                         DynamicTranslationGenerationFunc a_providerGeneration);
+
+    // True once a script has pushed a result for a key that no config registers.
+    // Such keys cannot be served from the KeyIndex and need the slow lookup path.
+    bool HasUnregisteredResults();
+
+    // Drop memoized native results so the next translate calls the provider again. Results of calls that were
+    // already running are stored as outdated and not served either.
+    void InvalidateKey(std::string_view a_key);
+    void InvalidateAll();
+
+    void LogStats();
+}
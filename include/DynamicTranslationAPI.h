@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+// Binary interface shared with provider DLLs. Only plain C types cross the module boundary so providers can be built
+// with any compiler. Providers may copy this header as-is.
+//
+// v1: const wchar_t* __cdecl OnDynamicTranslationRequest(std::string_view key)
+// v2: std::uint32_t __cdecl OnDynamicTranslationRequestBatch(DTFBatchRequest* request)
+//
+// A v2 provider that needs longer than a frame may answer kDTFPending for a key and deliver the text later through
+// the framework export
+//     void __cdecl DynamicTranslationCompleteRequest(const char* key, const wchar_t* result)
+// (key null-terminated UTF-8 without the leading '$'), callable from any thread.
+extern "C" {
+    constexpr std::uint32_t DTF_ABI_VERSION = 2;
+
+    enum DTFStatus : std::uint32_t {
+        kDTFOk = 0,
+        kDTFNoResult = 1,           // per result: provider has no text for this key
+        kDTFArenaFull = 2,          // return value: arena too small, caller grows it and retries
+        kDTFUnsupportedVersion = 3, // return value: provider cannot serve this abiVersion
+        kDTFPending = 4             // per result: provider delivers later via DynamicTranslationCompleteRequest
+    };
+
+    // UTF-8 key without the leading '$', not null-terminated
+    struct DTFKey {
+        const char* data;
+        std::uint32_t size;
+    };
+
+    // UTF-16 result located at arena[offset, offset + size)
+    struct DTFResult {
+        std::uint32_t offset;
+        std::uint32_t size;
+        std::uint32_t status;
+    };
+
+    struct DTFBatchRequest {
+        std::uint32_t abiVersion;     // DTF_ABI_VERSION of the framework
+        std::uint32_t count;          // number of keys and results
+        const DTFKey* keys;
+        DTFResult* results;           // filled by the provider
+        wchar_t* arena;               // output buffer owned by the framework
+        std::uint32_t arenaCapacity;  // in UTF-16 code units
+        std::uint32_t arenaUsed;      // advanced by the provider as it writes results
+    };
+
+    using DynamicTranslationBatchFunc = std::uint32_t(__cdecl*)(DTFBatchRequest* a_request);
+}
\ No newline at end of file
@@ -1,21 +1,15 @@
 #pragma once
-#include <unordered_map>
-#include <shared_mutex>
+#include "Core/Translator.h"
 
 namespace DynamicTranslationSE {
-    using DynamicTranslationFunc = const wchar_t*(__cdecl*)(std::string_view);
-    using PapyrusScriptID = std::pair<RE::FormID, std::string>; // formID, editorID
-
-    struct Provider {
-        HMODULE hmod{};
-        DynamicTranslationFunc native{};
-        PapyrusScriptID scriptID{};
-    };
-
-    inline std::shared_mutex gProvMutex;
-    inline std::unordered_map<std::string, Provider> gProvidersByKey;
-
-    std::wstring InvokeProvider(const Provider& prov, const std::string& a_key);
+    // Connects the translation core to the game: UI frame ticks and Papyrus dispatch
+    void InstallGameHost();
 
     bool InstallBindings(RE::BSScript::IVirtualMachine* vm);
+}
+
+// Exported for provider DLLs (resolve with GetProcAddress on this plugin's module)
+extern "C" {
+    __declspec(dllexport) void __cdecl DynamicTranslationInvalidateKey(const char* a_key);
+    __declspec(dllexport) void __cdecl DynamicTranslationInvalidateAll();
 }
\ No newline at end of file
@@ -11,4 +11,16 @@ namespace Hooks {
 
     // Install the GFx translator vtable hook. Safe to call once at DataLoaded.
     bool InstallTranslatorVtableHook();
+
+    // Periodic housekeeping tied to menus closing (e.g. flushing stats to the log)
+    class MenuEventSink : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
+    public:
+        static MenuEventSink* GetSingleton() {
+            static MenuEventSink singleton;
+            return &singleton;
+        }
+
+        RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event,
+                                              RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override;
+    };
 }
\ No newline at end of file
@@ -1,29 +1,56 @@
-﻿#pragma once
+#pragma once
 #include "DynamicTranslationSE.h"
 #include "Settings.h"
 #include "CLibUtilsQTR/Papyrus.hpp"
 
-class PapyrusWrapper : public REX::Singleton<PapyrusWrapper> {
+// Dispatches translation requests to provider scripts. Script objects are resolved once per provider and kept until
+// a game is loaded or started, or until their form is deleted; a cached object that the VM no longer considers valid
+// is resolved again.
+class PapyrusWrapper : public REX::Singleton<PapyrusWrapper>, public RE::BSTEventSink<RE::TESFormDeleteEvent> {
 public:
-    static RE::BSScript::IVirtualMachine::Awaitable GetDynamicTranslation(
-        const DynamicTranslationSE::PapyrusScriptID& scriptID,
-        const std::string& a_key) {
-        if (const auto a_form = RE::TESForm::LookupByID(scriptID.first)) {
-            if (const auto vm = Papyrus::VM::GetSingleton()) {
-                auto lock = RE::BSSpinLockGuard(vm->attachedScriptsLock);
-                if (const auto a_script = Papyrus::GetAttachedScript(scriptID.second, a_form)) {
-                    if (auto obj = static_cast<RE::BSTSmartPointer<RE::BSScript::Object>>(a_script->get())) {
-                        using namespace DynamicTranslationFrameworkSE;
-                        const auto vmargs = RE::MakeFunctionArguments(static_cast<std::string>(a_key));
-                        auto a_awaitable = vm->ADispatchMethodCall(obj, api_function_name, vmargs);
-                        delete vmargs;
-                        logger::info("GetDynamicTranslation: dispatched method call to script '{}'",
-                                     scriptID.second);
-                        return a_awaitable;
-                    }
-                }
-            }
-        }
-        return {};
-    }
-};
\ No newline at end of file
+    using Awaitable = RE::BSScript::IVirtualMachine::Awaitable;
+
+    struct Counters {
+        std::uint64_t hits{};
+        std::uint64_t misses{};
+        std::uint64_t invalidations{};
+    };
+
+    // Registers for form deletions; call once at DataLoaded
+    void Install();
+
+    Awaitable GetDynamicTranslation(const DynamicTranslationSE::PapyrusScriptID& scriptID, const std::string& a_key);
+
+    // Dispatches all a_keys in one call if the script implements the batch event; nothing when it does not, so the
+    // caller can fall back to one GetDynamicTranslation per key
+    std::optional<Awaitable> GetDynamicTranslationBatch(const DynamicTranslationSE::PapyrusScriptID& scriptID,
+                                                        const std::vector<std::string>& a_keys);
+
+    // Forgets every cached script object, e.g. when a save is loaded
+    void InvalidateScripts();
+
+    [[nodiscard]] Counters GetCounters() const;
+    void LogStats() const;
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESFormDeleteEvent* a_event,
+                                          RE::BSTEventSource<RE::TESFormDeleteEvent>*) override;
+
+private:
+    struct CachedScript {
+        RE::BSTSmartPointer<RE::BSScript::Object> object;
+        bool hasBatch{false};
+    };
+
+    // Cached object of the script, or a fresh lookup under attachedScriptsLock
+    std::optional<CachedScript> Resolve(const DynamicTranslationSE::PapyrusScriptID& scriptID);
+
+    // Searches the script and the scripts it extends
+    static bool HasMethod(RE::BSScript::Object& a_object, const RE::BSFixedString& a_name);
+
+    mutable std::mutex mutex;
+    std::map<DynamicTranslationSE::PapyrusScriptID, CachedScript> scripts;
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> invalidations{0};
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include "Core/Rules.h"
+
+namespace DynamicTranslationSE::RuleOperands {
+    // Game values a rule can test or print:
+    //     global:<editor ID>   value of a TESGlobal
+    //     quest:<editor ID>    current stage of a quest
+    //     av:<name>            the player's current actor value, e.g. av:Health
+    //     avbase:<name>        the player's base actor value
+    std::optional<Rules::Operand> Resolve(std::string_view a_kind, std::string_view a_name);
+}
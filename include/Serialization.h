@@ -0,0 +1,6 @@
+#pragma once
+
+namespace DynamicTranslationSE::Serialization {
+    // Keeps the Papyrus result cache in the SKSE co-save so labels are correct on the first frame after a load
+    void Install();
+}
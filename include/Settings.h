@@ -1,6 +1,23 @@
 #pragma once
+#include "Core/CoreSettings.h"
 
 namespace DynamicTranslationFrameworkSE {
     constexpr std::string_view kConfigFolder = R"(Data\SKSE\Plugins\DynamicTranslationFramework)";
+    // Binary image of the merged configs, written into kConfigFolder
+    constexpr std::string_view kRegistryCacheName = "DynamicTranslationFramework.cache";
+    // Provider DLLs are loaded when one of their keys is first translated instead of at DataLoaded
+    constexpr bool kLazyProviderDLLs = true;
+    // Loads the deferred DLLs on a background thread once the main menu opened
+    constexpr bool kPrewarmProviderDLLs = true;
+
     inline RE::BSFixedString api_function_name = "OnDynamicTranslationRequest";
+    // Optional: string[] OnDynamicTranslationRequestBatch(string[] keys), one call per script and UI frame
+    inline RE::BSFixedString api_batch_function_name = "OnDynamicTranslationRequestBatch";
+    // Papyrus arrays hold at most 128 elements, so larger batches go out as several calls
+    constexpr std::size_t kMaxPapyrusBatchKeys = 128;
+
+    // Translation statistics are rewritten to this file in the SKSE log folder
+    constexpr std::string_view kStatsFileName = "DynamicTranslationFrameworkSE.stats.txt";
+    // Translate-call captures started from Papyrus go to this file in the SKSE log folder
+    constexpr std::string_view kTraceFileName = "DynamicTranslationFrameworkSE.trace";
 }
\ No newline at end of file
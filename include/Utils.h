@@ -1,15 +1,6 @@
 #pragma once
 
 namespace Utils {
-    inline std::string WideToUtf8(const wchar_t* w) {
-        if (!w) return {};
-        const int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
-        if (len <= 1) return {};
-        std::string out(len - 1, '\0');
-        WideCharToMultiByte(CP_UTF8, 0, w, -1, out.data(), len, nullptr, nullptr);
-        return out;
-    }
-
     struct FireAndForget {
         struct promise_type {
             static FireAndForget get_return_object() noexcept { return {}; }
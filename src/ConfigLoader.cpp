@@ -1,6 +1,10 @@
 #include "ConfigLoader.h"
+#include "Core/ProviderRegistry.h"
 #include "Settings.h"
-#include <rapidjson/error/en.h>
+#include "Core/Stats.h"
+#include "Core/Text.h"
+#include "RuleOperands.h"
+#include <rapidjson/document.h>
 
 namespace DynamicTranslationSE {
     HMODULE ConfigLoader::GetOrLoadDLL(const std::string& dllName) {
@@ -11,17 +15,7 @@ namespace DynamicTranslationSE {
             return it->second;
         }
 
-        // Convert to wide string for LoadLibraryW
-        const int wideLen = MultiByteToWideChar(CP_UTF8, 0, dllName.c_str(), -1, nullptr, 0);
-        if (wideLen <= 0) {
-            logger::error("ConfigLoader: Failed to convert DLL name to wide string: {}", dllName);
-            return nullptr;
-        }
-
-        std::wstring wideName(wideLen, L'\0');
-        MultiByteToWideChar(CP_UTF8, 0, dllName.c_str(), -1, wideName.data(), wideLen);
-
-        const HMODULE hmod = LoadLibraryW(wideName.c_str());
+        const HMODULE hmod = LoadLibraryW(Text::Utf8ToWide(dllName).c_str());
         if (!hmod) {
             logger::error("ConfigLoader: Failed to load DLL: {} (error: {})", dllName, GetLastError());
             return nullptr;
@@ -46,64 +40,206 @@ namespace DynamicTranslationSE {
         return reinterpret_cast<DynamicTranslationFunc>(proc);
     }
 
-    void ConfigLoader::ProcessConfigEntry(const ConfigEntryBlock& entry, const std::string& filePath) {
-        const auto& strings = entry.strings.get();
-        const auto& dllName = entry.dll.get();
-        const auto& editorId = entry.papyrus.get();
-        const auto form = RE::TESForm::LookupByEditorID(editorId.c_str());
-        const auto formID = form ? form->GetFormID() : 0;
+    std::shared_ptr<NativeBatchGroup> ConfigLoader::GetOrCreateBatchGroup(HMODULE hmod, const std::string& dllName) {
+        std::lock_guard lock(dllCacheMutex);
 
-        const bool hasDll = !dllName.empty();
-        const bool hasPapyrus = formID > 0 && !editorId.empty();
+        if (const auto it = batchGroups.find(dllName); it != batchGroups.end()) {
+            return it->second;
+        }
 
-        if (!hasDll && !hasPapyrus) {
-            logger::warn("ConfigLoader: Entry in '{}' has neither 'dll' nor 'papyrus', skipping", filePath);
-            return;
+        std::shared_ptr<NativeBatchGroup> group;
+        if (const auto proc = GetProcAddress(hmod, "OnDynamicTranslationRequestBatch")) {
+            group = std::make_shared<NativeBatchGroup>(dllName, reinterpret_cast<DynamicTranslationBatchFunc>(proc));
+            logger::info("ConfigLoader: DLL '{}' provides the batch ABI", dllName);
         }
+        batchGroups[dllName] = group;
+        return group;
+    }
 
-        // Load DLL and resolve fixed function name if native
-        HMODULE hmod = nullptr;
-        DynamicTranslationFunc nativeFunc = nullptr;
-        if (hasDll) {
-            hmod = GetOrLoadDLL(dllName);
-            if (hmod) {
-                nativeFunc = ResolveDLLFunction(hmod, "OnDynamicTranslationRequest");
-                if (!nativeFunc) {
-                    logger::error(
-                        "ConfigLoader: Failed to resolve native function 'OnDynamicTranslationRequest' from DLL '{}' in '{}'",
-                        dllName, filePath);
-                    if (!hasPapyrus) {
-                        return;
-                    }
-                }
-            } else {
-                if (!hasPapyrus) {
-                    return;
-                }
+    std::shared_ptr<AsyncQueue> ConfigLoader::GetOrCreateAsyncQueue(const std::string& dllName,
+                                                                    const std::uint32_t limit) {
+        std::lock_guard lock(dllCacheMutex);
+        // Every async entry of a DLL shares one queue; the first entry decides its limit
+        if (const auto it = asyncQueues.find(dllName); it != asyncQueues.end()) {
+            if (limit && it->second->Limit() != limit) {
+                logger::warn("ConfigLoader: DLL '{}' already uses an async queue limit of {}, ignoring {}", dllName,
+                             it->second->Limit(), limit);
             }
+            return it->second;
         }
 
-        // Process strings
-        for (const auto& a_str : strings) {
-            if (a_str.empty()) {
-                logger::warn("ConfigLoader: Empty translation string in entry from '{}', skipping", filePath);
-                continue;
+        const auto queue = std::make_shared<AsyncQueue>(
+            dllName, limit ? limit : DynamicTranslationFrameworkSE::kDefaultAsyncQueueLimit);
+        asyncQueues[dllName] = queue;
+        return queue;
+    }
+
+    std::shared_ptr<CircuitBreaker> ConfigLoader::GetOrCreateBreaker(const std::string& name) {
+        std::lock_guard lock(dllCacheMutex);
+        auto& breaker = breakers[name];
+        if (!breaker) {
+            breaker = std::make_shared<CircuitBreaker>(name);
+        }
+        return breaker;
+    }
+
+    std::shared_ptr<LazyProvider> ConfigLoader::GetOrCreateLazyProvider(const EntrySpec& spec,
+                                                                        const Provider& unbound) {
+        std::lock_guard lock(dllCacheMutex);
+        // BindDLL only reads these fields of the spec, so entries that agree on them and on the rest of the provider
+        // bind to the same provider
+        auto& bindings = lazyBindings[spec.dll];
+        for (const auto& binding : bindings) {
+            if (binding.unbound == unbound && binding.memoize == spec.memoize && binding.async == spec.async &&
+                binding.asyncQueueLimit == spec.asyncQueueLimit) {
+                return binding.lazy;
+            }
+        }
+
+        // Only the DLL name is kept; the first translate of one of the entry's keys loads it
+        auto lazy = std::make_shared<LazyProvider>([spec, unbound] {
+            const auto start = std::chrono::steady_clock::now();
+            auto bound = unbound;
+            BindDLL(spec, bound);
+            const auto elapsed =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            logger::info("ConfigLoader: Bound DLL '{}' on first use in {} us", spec.dll, elapsed.count());
+            return bound;
+        });
+        bindings.push_back({unbound, spec.memoize, spec.async, spec.asyncQueueLimit, lazy});
+        lazyProviders.push_back(lazy);
+        return lazy;
+    }
+
+    bool ConfigLoader::BindDLL(const EntrySpec& spec, Provider& prov) {
+        const auto& dllName = spec.dll;
+        const auto hmod = GetOrLoadDLL(dllName);
+        if (!hmod) {
+            return false;
+        }
+
+        // The v2 batch ABI and the generation counter are optional, so they are probed quietly.
+        // A DLL that exports the batch ABI does not need the v1 function.
+        const auto batchGroup = GetOrCreateBatchGroup(hmod, dllName);
+        const auto generationFunc =
+            reinterpret_cast<DynamicTranslationGenerationFunc>(GetProcAddress(hmod, "GetDynamicTranslationGeneration"));
+        const auto nativeFunc =
+            batchGroup ? reinterpret_cast<DynamicTranslationFunc>(GetProcAddress(hmod, "OnDynamicTranslationRequest"))
+                       : ResolveDLLFunction(hmod, "OnDynamicTranslationRequest");
+        if (!nativeFunc && !batchGroup) {
+            logger::error("ConfigLoader: Failed to resolve native function 'OnDynamicTranslationRequest' from DLL '{}'",
+                          dllName);
+            return false;
+        }
+
+        prov.native = nativeFunc;
+        prov.generation = generationFunc;
+        prov.batch = batchGroup;
+        prov.memoize = spec.memoize;
+        if (spec.async) {
+            prov.async = GetOrCreateAsyncQueue(dllName, spec.asyncQueueLimit);
+        }
+        return true;
+    }
+
+    std::shared_ptr<const Rules::RuleSet> ConfigLoader::CompileRules(const EntrySpec& spec) {
+        const std::string owner = !spec.papyrus.empty() ? spec.papyrus : !spec.dll.empty() ? spec.dll : "rules";
+        rapidjson::Document doc;
+        doc.Parse(spec.rules.c_str(), spec.rules.size());
+        if (doc.HasParseError() || !doc.IsArray()) {
+            logger::error("ConfigLoader: Rules of '{}' are not a JSON array", owner);
+            return nullptr;
+        }
+
+        const auto strings = [](const rapidjson::Value& a_block, const char* a_name) {
+            std::vector<std::string> out;
+            const auto it = a_block.FindMember(a_name);
+            if (it == a_block.MemberEnd()) {
+                return out;
+            }
+            if (it->value.IsString()) {
+                out.emplace_back(it->value.GetString(), it->value.GetStringLength());
+            } else if (it->value.IsArray()) {
+                for (const auto& item : it->value.GetArray()) {
+                    if (item.IsString()) {
+                        out.emplace_back(item.GetString(), item.GetStringLength());
+                    }
+                }
             }
+            return out;
+        };
 
-            Provider prov{};
-            prov.hmod = hmod;
-            prov.native = nativeFunc;
-            if (hasPapyrus) {
-                prov.scriptID = {formID, editorId};
+        std::vector<Rules::RuleSource> sources;
+        for (const auto& rule : doc.GetArray()) {
+            if (!rule.IsObject() || !rule.HasMember("text") || !rule["text"].IsString()) {
+                logger::error("ConfigLoader: A rule of '{}' has no 'text'", owner);
+                return nullptr;
             }
+            sources.push_back({strings(rule, "when"), rule["text"].GetString(), strings(rule, "args")});
+        }
+        return Rules::RuleSet::Compile(sources, RuleOperands::Resolve, owner);
+    }
 
-            {
-                std::unique_lock lock(gProvMutex);
-                gProvidersByKey[a_str] = std::move(prov);
+    std::optional<Provider> ConfigLoader::ResolveEntry(const EntrySpec& spec) {
+        using namespace DynamicTranslationFrameworkSE;
+        const auto& dllName = spec.dll;
+        const auto& editorId = spec.papyrus;
+        const auto form = editorId.empty() ? nullptr : RE::TESForm::LookupByEditorID(editorId.c_str());
+        const auto formID = form ? form->GetFormID() : 0;
+
+        const bool hasDll = !dllName.empty();
+        const bool hasPapyrus = formID > 0;
+        const auto rules = spec.rules.empty() ? nullptr : CompileRules(spec);
+
+        if (!hasDll && !hasPapyrus && !rules) {
+            if (spec.rules.empty()) {
+                logger::warn("ConfigLoader: Papyrus form '{}' not found, skipping its entry", editorId);
             }
+            return std::nullopt;
+        }
 
-            logger::info("ConfigLoader: Registered provider for translation string '{}'", a_str);
+        Provider prov{};
+        prov.rules = rules;
+        prov.ttl = std::chrono::milliseconds(spec.ttlMs);
+        const std::string name = hasDll ? dllName : !editorId.empty() ? editorId : "rules";
+        prov.statsId = Stats::RegisterProvider(name);
+        prov.breaker = GetOrCreateBreaker(name);
+        if (spec.budgetUs) {
+            prov.budget = std::chrono::microseconds(spec.budgetUs);
+        }
+        if (hasPapyrus) {
+            prov.scriptID = {formID, editorId};
+            prov.refresh = spec.refresh;
+            prov.refreshInterval = std::chrono::milliseconds(spec.refreshIntervalMs);
         }
+
+        if (hasDll && kLazyProviderDLLs) {
+            prov.lazy = GetOrCreateLazyProvider(spec, prov);
+        } else if (hasDll && !BindDLL(spec, prov) && !hasPapyrus && !rules) {
+            return std::nullopt;
+        }
+        return prov;
+    }
+
+    KeyIndex::Source ConfigLoader::ResolveRegistry(const RegistrySpec& spec) {
+        // Forms and DLLs are resolved once per entry, not once per key; entries that resolve to the same provider
+        // share its slot in the table
+        KeyIndex::Source source;
+        std::vector<std::optional<std::uint32_t>> resolved;
+        resolved.reserve(spec.entries.size());
+        for (const auto& entry : spec.entries) {
+            const auto prov = ResolveEntry(entry);
+            resolved.push_back(prov ? std::optional(source.Intern(*prov)) : std::nullopt);
+        }
+
+        source.keys.reserve(spec.keys.size());
+        for (const auto& [key, entryIndex] : spec.keys) {
+            if (const auto provider = resolved[entryIndex]) {
+                source.keys.emplace_back(key, *provider);
+                logger::debug("ConfigLoader: Registered provider for translation string '{}'", key);
+            }
+        }
+        return source;
     }
 
     void ConfigLoader::Load() {
@@ -115,11 +251,9 @@ namespace DynamicTranslationSE {
 
         logger::info("ConfigLoader: Loading configurations from {}", kConfigFolder);
 
-        {
-            std::unique_lock lock(gProvMutex);
-            gProvidersByKey.clear();
-        }
+        const auto start = std::chrono::steady_clock::now();
 
+        std::vector<ConfigFile> files;
         std::error_code ec;
         for (const auto& entry : std::filesystem::directory_iterator(kConfigFolder, ec)) {
             if (ec) {
@@ -136,46 +270,80 @@ namespace DynamicTranslationSE {
                 continue;
             }
 
-            const std::string filePath = path.string();
-            logger::info("ConfigLoader: Processing file: {}", filePath);
+            files.push_back({path, path.string(), {}});
+        }
 
-            std::ifstream ifs(path);
-            if (!ifs.is_open()) {
-                logger::error("ConfigLoader: Failed to open file: {}", filePath);
-                continue;
-            }
+        // Merge order is the filename order, independent of how the directory happens to be enumerated
+        std::ranges::sort(files, {}, [](const ConfigFile& file) { return file.path.filename(); });
 
-            std::string jsonStr((std::istreambuf_iterator(ifs)), std::istreambuf_iterator<char>());
-            ifs.close();
+        Manifest manifest;
+        manifest.reserve(files.size());
+        for (const auto& file : files) {
+            std::error_code sizeEc, timeEc;
+            const auto size = std::filesystem::file_size(file.path, sizeEc);
+            const auto mtime = std::filesystem::last_write_time(file.path, timeEc);
+            manifest.push_back({file.path.filename().string(), sizeEc ? 0 : size,
+                                timeEc ? 0 : static_cast<std::int64_t>(mtime.time_since_epoch().count())});
+        }
 
-            rapidjson::Document doc;
-            doc.Parse(jsonStr.c_str());
+        // Warm start: the binary image is reused as long as no config file was added, removed or touched
+        const auto cachePath = std::filesystem::path(kConfigFolder) / kRegistryCacheName;
+        RegistrySpec spec;
+        const bool warm = RegistryCache::Read(cachePath, manifest, spec);
+        if (!warm) {
+            ConfigParser::ParseFiles(files);
+            spec = ConfigParser::Merge(files);
+            RegistryCache::Write(cachePath, manifest, spec);
+        }
 
-            if (doc.HasParseError()) {
-                logger::error("ConfigLoader: JSON parse error in '{}' at offset {}: {}",
-                              filePath, doc.GetErrorOffset(), rapidjson::GetParseError_En(doc.GetParseError()));
-                continue;
-            }
+        const auto parsed = std::chrono::steady_clock::now();
 
-            if (doc.IsArray()) {
-                for (auto& item : doc.GetArray()) {
-                    if (!item.IsObject()) {
-                        logger::warn("ConfigLoader: Array item in '{}' is not an object, skipping", filePath);
-                        continue;
-                    }
-                    ConfigEntryBlock block;
-                    block.load(item);
-                    ProcessConfigEntry(block, filePath);
-                }
-            } else if (doc.IsObject()) {
-                ConfigEntryBlock block;
-                block.load(doc);
-                ProcessConfigEntry(block, filePath);
-            } else {
-                logger::error("ConfigLoader: Root element in '{}' is neither object nor array", filePath);
-            }
+        // Form lookups and DLL loading stay on this thread.
+        // Build the new registry off to the side; readers keep using the published one until the swap
+        auto source = ResolveRegistry(spec);
+        const auto keyCount = source.keys.size();
+        const auto resolved = std::chrono::steady_clock::now();
+
+        auto index = std::make_unique<KeyIndex>();
+        index->Build(std::move(source));
+        ProviderRegistry::Publish(std::move(index));
+
+        const auto end = std::chrono::steady_clock::now();
+        const auto ms = [](const std::chrono::steady_clock::duration a_duration) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(a_duration).count() / 1000.0;
+        };
+        std::size_t loaded, deferred;
+        {
+            std::lock_guard lock(dllCacheMutex);
+            loaded = dllCache.size();
+            deferred = lazyProviders.size();
+        }
+        logger::info("ConfigLoader: Configuration loading complete ({} start): {} files, {} keys in {:.2f} ms",
+                     warm ? "warm" : "cold", files.size(), keyCount, ms(end - start));
+        logger::info("ConfigLoader: Startup time: configs {:.2f} ms, resolve {:.2f} ms ({} DLLs loaded, {} providers "
+                     "deferred), index {:.2f} ms",
+                     ms(parsed - start), ms(resolved - parsed), loaded, deferred, ms(end - resolved));
+    }
+
+    void ConfigLoader::Prewarm() {
+        std::vector<std::shared_ptr<LazyProvider>> pending;
+        {
+            std::lock_guard lock(dllCacheMutex);
+            pending.swap(lazyProviders);
+        }
+        if (pending.empty()) {
+            return;
         }
 
-        logger::info("ConfigLoader: Configuration loading complete");
+        // Loading runs off the UI thread; a translate that needs a DLL before its turn here binds it itself
+        std::thread([pending = std::move(pending)] {
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& lazy : pending) {
+                lazy->Get();
+            }
+            const auto elapsed =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            logger::info("ConfigLoader: Prewarmed {} deferred providers in {} ms", pending.size(), elapsed.count());
+        }).detach();
     }
 }
\ No newline at end of file
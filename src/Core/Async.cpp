@@ -0,0 +1,141 @@
+#include "Core/Async.h"
+#include "Core/CoreSettings.h"
+
+namespace DynamicTranslationSE {
+    AsyncPool& AsyncPool::GetSingleton() {
+        static AsyncPool singleton;
+        return singleton;
+    }
+
+    AsyncPool::~AsyncPool() {
+        Shutdown();
+    }
+
+    const AsyncPool::Busy* AsyncPool::FindBusy(const std::string_view a_key) const {
+        const auto it = busy.find(a_key);
+        if (it == busy.end() || it->second.epoch != epoch) {
+            return nullptr;
+        }
+        if (it->second.pending &&
+            std::chrono::steady_clock::now() - it->second.since > DynamicTranslationFrameworkSE::kAsyncPendingTimeout) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    bool AsyncPool::Submit(AsyncQueue& a_queue, const std::string& a_key, Job a_job) {
+        {
+            std::lock_guard lock(mutex);
+            if (FindBusy(a_key)) {
+                return false;
+            }
+            if (a_queue.queued >= a_queue.limit) {
+                ++counters.rejected;
+                return false;
+            }
+
+            if (workers.empty()) {
+                for (std::uint32_t i = 0; i < DynamicTranslationFrameworkSE::kAsyncWorkerThreads; ++i) {
+                    workers.emplace_back([this](const std::stop_token a_stop) { WorkerLoop(a_stop); });
+                }
+            }
+
+            ++a_queue.queued;
+            ++counters.submitted;
+            busy.insert_or_assign(a_key, Busy{std::chrono::steady_clock::now(), epoch});
+            tasks.push_back({&a_queue, a_key, epoch, std::move(a_job)});
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    void AsyncPool::MarkPending(const std::string& a_key, const std::chrono::milliseconds a_ttl,
+                                const std::uint64_t a_generation) {
+        std::lock_guard lock(mutex);
+        busy.insert_or_assign(a_key, Busy{std::chrono::steady_clock::now(), epoch, true, {a_ttl, a_generation}});
+    }
+
+    std::optional<AsyncPool::PendingRequest> AsyncPool::TakePending(const std::string_view a_key) {
+        std::lock_guard lock(mutex);
+        const auto found = FindBusy(a_key);
+        if (!found || !found->pending) {
+            return std::nullopt;
+        }
+        const auto request = found->request;
+        busy.erase(busy.find(a_key));
+        return request;
+    }
+
+    bool AsyncPool::IsBusy(const std::string_view a_key) const {
+        std::lock_guard lock(mutex);
+        return FindBusy(a_key) != nullptr;
+    }
+
+    void AsyncPool::CancelAll() {
+        std::lock_guard lock(mutex);
+        // Jobs of the old epoch are discarded when a worker picks them up, which also releases their queue slot
+        ++epoch;
+        busy.clear();
+    }
+
+    void AsyncPool::Shutdown() {
+        std::vector<std::jthread> stopping;
+        {
+            std::lock_guard lock(mutex);
+            stopping.swap(workers);
+            for (auto& worker : stopping) {
+                worker.request_stop();
+            }
+        }
+        wake.notify_all();
+        stopping.clear();
+
+        std::lock_guard lock(mutex);
+        for (const auto& task : tasks) {
+            --task.queue->queued;
+        }
+        tasks.clear();
+        busy.clear();
+    }
+
+    AsyncPool::Counters AsyncPool::GetCounters() const {
+        std::lock_guard lock(mutex);
+        return counters;
+    }
+
+    void AsyncPool::WorkerLoop(const std::stop_token a_stop) {
+        std::unique_lock lock(mutex);
+        while (true) {
+            if (!wake.wait(lock, a_stop, [this] { return !tasks.empty(); })) {
+                return;
+            }
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            --task.queue->queued;
+            if (task.epoch != epoch) {
+                ++counters.cancelled;
+                continue;
+            }
+
+            lock.unlock();
+            try {
+                task.job();
+            } catch (const std::exception& e) {
+                spdlog::error("AsyncPool: Request for key '{}' from '{}' failed: {}", task.key, task.queue->Name(),
+                              e.what());
+            } catch (...) {
+                spdlog::error("AsyncPool: Request for key '{}' from '{}' failed", task.key, task.queue->Name());
+            }
+            lock.lock();
+
+            ++counters.completed;
+            // A job that ended in MarkPending keeps its key busy until the provider delivers. After a CancelAll during
+            // the job the key may already be busy again for a newer submission, which is not this job's to release.
+            if (const auto it = busy.find(task.key);
+                it != busy.end() && it->second.epoch == task.epoch && !it->second.pending) {
+                busy.erase(it);
+            }
+        }
+    }
+}
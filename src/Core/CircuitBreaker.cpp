@@ -0,0 +1,70 @@
+#include "Core/CircuitBreaker.h"
+#include "Core/CoreSettings.h"
+
+namespace DynamicTranslationSE {
+    namespace {
+        std::int64_t Micros(const CircuitBreaker::Clock::duration a_duration) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(a_duration).count();
+        }
+    }
+
+    bool CircuitBreaker::Allow() {
+        const auto until = openUntil.load(std::memory_order_acquire);
+        if (until == 0) {
+            return true;
+        }
+        const auto now = Clock::now();
+        const auto ticks = now.time_since_epoch().count();
+        auto probe = probeUntil.load(std::memory_order_acquire);
+        const auto deadline = (now + DynamicTranslationFrameworkSE::kBreakerProbeTimeout).time_since_epoch().count();
+        if (ticks < until || (probe != 0 && ticks < probe) ||
+            !probeUntil.compare_exchange_strong(probe, deadline, std::memory_order_acq_rel)) {
+            skipped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void CircuitBreaker::Report(const Clock::duration a_elapsed, const Clock::duration a_budget) {
+        if (a_elapsed > a_budget) {
+            Strike(fmt::format("took {} us, over its {} us budget", Micros(a_elapsed), Micros(a_budget)));
+            return;
+        }
+        if (strikes.load(std::memory_order_relaxed) != 0) {
+            strikes.store(0, std::memory_order_relaxed);
+        }
+        if (openUntil.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+
+        std::lock_guard lock(mutex);
+        if (probeUntil.load(std::memory_order_acquire) != 0) {
+            backoff = {};
+            openUntil.store(0, std::memory_order_release);
+            probeUntil.store(0, std::memory_order_release);
+            spdlog::info("CircuitBreaker: Provider '{}' recovered, calling it again", name);
+        }
+    }
+
+    void CircuitBreaker::Fail(const std::string_view a_reason) {
+        Strike(a_reason);
+    }
+
+    void CircuitBreaker::Strike(const std::string_view a_reason) {
+        using namespace DynamicTranslationFrameworkSE;
+
+        std::lock_guard lock(mutex);
+        const bool failedProbe = probeUntil.load(std::memory_order_acquire) != 0;
+        if (!failedProbe && strikes.fetch_add(1, std::memory_order_relaxed) + 1 < kBreakerTripOverruns) {
+            return;
+        }
+
+        backoff = failedProbe ? std::min<Clock::duration>(backoff * 2, kBreakerMaxBackoff) : kBreakerInitialBackoff;
+        strikes.store(0, std::memory_order_relaxed);
+        openUntil.store((Clock::now() + backoff).time_since_epoch().count(), std::memory_order_release);
+        probeUntil.store(0, std::memory_order_release);
+        trips.fetch_add(1, std::memory_order_relaxed);
+        spdlog::warn("CircuitBreaker: Provider '{}' {}; skipping it for {} ms", name, a_reason,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(backoff).count());
+    }
+}
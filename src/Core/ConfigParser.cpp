@@ -0,0 +1,184 @@
+#include "Core/ConfigParser.h"
+#include <execution>
+#include <fstream>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace {
+    // Members that are missing or of another type keep their default
+    void Read(const rapidjson::Value& a_block, const char* a_name, std::string& a_out) {
+        if (const auto it = a_block.FindMember(a_name); it != a_block.MemberEnd() && it->value.IsString()) {
+            a_out.assign(it->value.GetString(), it->value.GetStringLength());
+        }
+    }
+
+    void Read(const rapidjson::Value& a_block, const char* a_name, bool& a_out) {
+        if (const auto it = a_block.FindMember(a_name); it != a_block.MemberEnd() && it->value.IsBool()) {
+            a_out = it->value.GetBool();
+        }
+    }
+
+    // Negative values count as 0
+    void Read(const rapidjson::Value& a_block, const char* a_name, std::uint32_t& a_out) {
+        if (const auto it = a_block.FindMember(a_name); it != a_block.MemberEnd() && it->value.IsInt()) {
+            a_out = static_cast<std::uint32_t>(std::max(it->value.GetInt(), 0));
+        }
+    }
+
+    void Read(const rapidjson::Value& a_block, const char* a_name, std::vector<std::string>& a_out) {
+        const auto it = a_block.FindMember(a_name);
+        if (it == a_block.MemberEnd() || !it->value.IsArray()) {
+            return;
+        }
+        for (const auto& item : it->value.GetArray()) {
+            if (item.IsString()) {
+                a_out.emplace_back(item.GetString(), item.GetStringLength());
+            }
+        }
+    }
+
+    // The "rules" array is kept as JSON text until it is compiled, so it fits the registry cache image
+    void ReadRules(const rapidjson::Value& a_block, std::string& a_out) {
+        const auto it = a_block.FindMember("rules");
+        if (it == a_block.MemberEnd() || !it->value.IsArray()) {
+            return;
+        }
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer writer(buffer);
+        it->value.Accept(writer);
+        a_out.assign(buffer.GetString(), buffer.GetSize());
+    }
+
+    DynamicTranslationSE::RefreshPolicy ReadRefreshPolicy(const rapidjson::Value& a_block,
+                                                          const std::string& a_filePath) {
+        using DynamicTranslationSE::RefreshPolicy;
+        std::string policy;
+        Read(a_block, "refresh", policy);
+        if (policy.empty() || policy == "always") {
+            return RefreshPolicy::kAlways;
+        }
+        if (policy == "interval") {
+            return RefreshPolicy::kInterval;
+        }
+        if (policy == "event") {
+            return RefreshPolicy::kEvent;
+        }
+        spdlog::warn("ConfigParser: Unknown refresh policy '{}' in '{}', using 'always'", policy, a_filePath);
+        return RefreshPolicy::kAlways;
+    }
+
+    DynamicTranslationSE::ConfigFile::Entry ReadEntry(const rapidjson::Value& a_block, const std::string& a_filePath) {
+        DynamicTranslationSE::ConfigFile::Entry entry;
+        auto& spec = entry.spec;
+        Read(a_block, "strings", entry.strings);
+        Read(a_block, "skse", spec.dll);
+        Read(a_block, "papyrus", spec.papyrus);
+        spec.refresh = ReadRefreshPolicy(a_block, a_filePath);
+        Read(a_block, "refreshIntervalMs", spec.refreshIntervalMs);
+        Read(a_block, "ttlMs", spec.ttlMs);
+        Read(a_block, "memoize", spec.memoize);
+        Read(a_block, "async", spec.async);
+        Read(a_block, "asyncQueueLimit", spec.asyncQueueLimit);
+        Read(a_block, "budgetUs", spec.budgetUs);
+        ReadRules(a_block, spec.rules);
+        return entry;
+    }
+}
+
+namespace DynamicTranslationSE {
+    void ConfigParser::ParseFile(ConfigFile& a_file) {
+        // One-shot read into a buffer that rapidjson then parses in place
+        std::ifstream ifs(a_file.path, std::ios::binary);
+        if (!ifs.is_open()) {
+            spdlog::error("ConfigParser: Failed to open file: {}", a_file.filePath);
+            return;
+        }
+
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(a_file.path, ec);
+        if (ec) {
+            spdlog::error("ConfigParser: Failed to read size of '{}': {}", a_file.filePath, ec.message());
+            return;
+        }
+
+        std::vector<char> buffer(static_cast<std::size_t>(size) + 1, '\0');
+        ifs.read(buffer.data(), static_cast<std::streamsize>(size));
+        ifs.close();
+
+        rapidjson::Document doc;
+        doc.ParseInsitu(buffer.data());
+
+        if (doc.HasParseError()) {
+            spdlog::error("ConfigParser: JSON parse error in '{}' at offset {}: {}", a_file.filePath,
+                          doc.GetErrorOffset(), rapidjson::GetParseError_En(doc.GetParseError()));
+            return;
+        }
+
+        if (doc.IsArray()) {
+            a_file.entries.reserve(doc.GetArray().Size());
+            for (const auto& item : doc.GetArray()) {
+                if (!item.IsObject()) {
+                    spdlog::warn("ConfigParser: Array item in '{}' is not an object, skipping", a_file.filePath);
+                    continue;
+                }
+                a_file.entries.push_back(ReadEntry(item, a_file.filePath));
+            }
+        } else if (doc.IsObject()) {
+            a_file.entries.push_back(ReadEntry(doc, a_file.filePath));
+        } else {
+            spdlog::error("ConfigParser: Root element in '{}' is neither object nor array", a_file.filePath);
+        }
+    }
+
+    void ConfigParser::ParseFiles(std::vector<ConfigFile>& a_files) {
+        // Reading and parsing has no side effects on the game, so it runs on the worker pool
+        std::for_each(std::execution::par, a_files.begin(), a_files.end(), ParseFile);
+    }
+
+    RegistrySpec ConfigParser::Merge(const std::vector<ConfigFile>& a_files) {
+        RegistrySpec spec;
+        KeyOrigins origins;
+        for (const auto& file : a_files) {
+            spdlog::info("ConfigParser: Processing file: {}", file.filePath);
+            for (const auto& entry : file.entries) {
+                CollectEntry(entry, file.filePath, spec, origins);
+            }
+        }
+        return spec;
+    }
+
+    void ConfigParser::CollectEntry(const ConfigFile::Entry& a_entry, const std::string& a_filePath,
+                                    RegistrySpec& a_spec, KeyOrigins& a_origins) {
+        const auto& entrySpec = a_entry.spec;
+        if (entrySpec.dll.empty() && entrySpec.papyrus.empty() && entrySpec.rules.empty()) {
+            spdlog::warn("ConfigParser: Entry in '{}' has neither 'dll', 'papyrus' nor 'rules', skipping", a_filePath);
+            return;
+        }
+        if (entrySpec.refresh == RefreshPolicy::kInterval && entrySpec.refreshIntervalMs == 0) {
+            spdlog::warn("ConfigParser: Entry in '{}' uses refresh 'interval' without 'refreshIntervalMs'", a_filePath);
+        }
+        if (entrySpec.async && entrySpec.dll.empty()) {
+            spdlog::warn("ConfigParser: Entry in '{}' sets 'async' without 'dll'; Papyrus calls are always async",
+                         a_filePath);
+        }
+
+        const auto entryIndex = static_cast<std::uint32_t>(a_spec.entries.size());
+        a_spec.entries.push_back(entrySpec);
+
+        for (const auto& a_str : a_entry.strings) {
+            if (a_str.empty()) {
+                spdlog::warn("ConfigParser: Empty translation string in entry from '{}', skipping", a_filePath);
+                continue;
+            }
+
+            if (const auto [it, inserted] = a_origins.try_emplace(a_str, a_filePath); !inserted) {
+                spdlog::info("ConfigParser: Key '{}' from '{}' overrides the one from '{}'", a_str, a_filePath,
+                             it->second);
+                it->second = a_filePath;
+            }
+            a_spec.keys[a_str] = entryIndex;
+        }
+    }
+}
@@ -0,0 +1,270 @@
+#include <cstring>
+#include <cwchar>
+#include <map>
+#include <ranges>
+#include "Core/KeyIndex.h"
+#include "Core/Text.h"
+
+namespace DynamicTranslationSE {
+    std::uint64_t KeyIndex::Hash(const wchar_t* a_key, const std::size_t a_len) noexcept {
+        std::uint64_t h = 14695981039346656037ull;
+        for (std::size_t i = 0; i < a_len; ++i) {
+            h ^= static_cast<std::make_unsigned_t<wchar_t>>(a_key[i]);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    std::uint32_t KeyIndex::Source::Intern(const Provider& a_provider) {
+        // Config entries number in the hundreds at most, so a scan beats hashing a Provider
+        if (const auto it = std::ranges::find(providers, a_provider); it != providers.end()) {
+            return static_cast<std::uint32_t>(it - providers.begin());
+        }
+        providers.push_back(a_provider);
+        return static_cast<std::uint32_t>(providers.size() - 1);
+    }
+
+    std::uint32_t KeyIndex::AddRecord(const std::string_view a_key, const std::wstring_view a_wideKey,
+                                      const std::uint32_t a_provider) {
+        const auto offset = records.size();
+        records.resize(offset + RecordSize(a_wideKey.size()));
+        const auto chars = reinterpret_cast<wchar_t*>(records.data() + offset + sizeof(Record));
+        std::memcpy(chars, a_wideKey.data(), a_wideKey.size() * sizeof(wchar_t));
+        new (records.data() + offset) Record{Hash(a_wideKey.data(), a_wideKey.size()),
+                                             static_cast<std::uint32_t>(keyText.size()),
+                                             a_provider,
+                                             0,
+                                             static_cast<std::uint16_t>(a_key.size()),
+                                             static_cast<std::uint16_t>(a_wideKey.size())};
+        keyText.append(a_key);
+        return static_cast<std::uint32_t>(offset);
+    }
+
+    void KeyIndex::Build(Source a_source) {
+        records.clear();
+        entryOffsets.clear();
+        slots.clear();
+        lengthMask = {};
+        maxLength = 0;
+        patternOffsets.clear();
+        keyText.clear();
+        providers = std::move(a_source.providers);
+        providers.shrink_to_fit();
+
+        // A key has at most as many UTF-16 units as UTF-8 bytes, so records never outgrow this and never move
+        std::size_t reserve = 0;
+        std::size_t textSize = 0;
+        for (const auto& key : a_source.keys | std::views::keys) {
+            reserve += RecordSize(key.size() + 1);
+            textSize += key.size();
+        }
+        records.reserve(reserve);
+        keyText.reserve(textSize);
+        entryOffsets.reserve(a_source.keys.size());
+        std::wstring wideKey;
+        for (const auto& [key, provider] : a_source.keys) {
+            if (provider >= providers.size()) {
+                spdlog::error("KeyIndex: Key '{}' names provider {} of {}, skipping", key, provider, providers.size());
+                continue;
+            }
+            bool pattern = false;
+            if (key.ends_with('*')) {
+                pattern = key.find('*') == key.size() - 1;
+                if (!pattern) {
+                    spdlog::warn("KeyIndex: Only a single trailing '*' is supported, treating '{}' as an exact key",
+                                 key);
+                }
+            }
+
+            wideKey.assign(L"$");
+            Text::AppendWide(wideKey, std::string_view(key).substr(0, key.size() - pattern));
+            if (wideKey.size() > kMaxKeyLength || key.size() > std::numeric_limits<std::uint16_t>::max()) {
+                spdlog::warn("KeyIndex: Key '{}' is longer than {} characters, skipping", key, kMaxKeyLength);
+                continue;
+            }
+            const auto offset = AddRecord(key, wideKey, provider);
+            if (pattern) {
+                patternOffsets.push_back(offset);
+                continue;
+            }
+            const auto len = wideKey.size();
+            lengthMask[len / 64] |= 1ull << (len % 64);
+            maxLength = std::max(maxLength, len);
+            entryOffsets.push_back(offset);
+        }
+        entryOffsets.shrink_to_fit();
+        patternOffsets.shrink_to_fit();
+
+        // Exact keys count first, then the families
+        std::uint32_t id = 0;
+        for (const auto offset : entryOffsets) {
+            std::launder(reinterpret_cast<Record*>(records.data() + offset))->id = id++;
+        }
+        for (const auto offset : patternOffsets) {
+            std::launder(reinterpret_cast<Record*>(records.data() + offset))->id = id++;
+        }
+
+        // Keep the load factor at or below 50% so probe chains stay short
+        std::size_t capacity = 16;
+        while (capacity < entryOffsets.size() * 2) {
+            capacity <<= 1;
+        }
+        slots.assign(capacity, 0);
+        slotMask = capacity - 1;
+
+        for (const auto offset : entryOffsets) {
+            const auto hash = RecordAt(offset).hash;
+            auto slot = static_cast<std::size_t>(hash) & slotMask;
+            while (slots[slot]) {
+                slot = (slot + 1) & slotMask;
+            }
+            slots[slot] = (hash & ~0xFFFFFFFFull) | (offset + 1);
+        }
+
+        BuildTrie();
+        hits = std::make_unique<std::atomic<std::uint32_t>[]>(size());
+
+        spdlog::info("KeyIndex: Built lookup index with {} keys and {} prefixes ({} trie nodes, {} providers, {} KiB)",
+                     entryOffsets.size(), patternOffsets.size(), trieNodes.size(), providers.size(),
+                     MemoryBytes() / 1024);
+    }
+
+    std::size_t KeyIndex::MemoryBytes() const noexcept {
+        return records.capacity() + entryOffsets.capacity() * sizeof(entryOffsets[0]) +
+               patternOffsets.capacity() * sizeof(patternOffsets[0]) + slots.capacity() * sizeof(slots[0]) +
+               trieNodes.capacity() * sizeof(TrieNode) + trieEdges.capacity() * sizeof(TrieEdge) +
+               providers.capacity() * sizeof(Provider) + keyText.capacity() +
+               size() * sizeof(std::atomic<std::uint32_t>);
+    }
+
+    void KeyIndex::BuildTrie() {
+        trieNodes.clear();
+        trieEdges.clear();
+        if (patternOffsets.empty()) {
+            return;
+        }
+
+        // Insert into a node-per-map trie first, then flatten it so every node's edges are one sorted run
+        struct BuildNode {
+            std::map<wchar_t, std::uint32_t> children;
+            std::uint32_t pattern{};
+        };
+        std::vector<BuildNode> nodes(1);
+        for (std::uint32_t i = 0; i < patternOffsets.size(); ++i) {
+            std::uint32_t node = 0;
+            const auto& record = RecordAt(patternOffsets[i]);
+            for (const auto c : std::wstring_view(WideKeyOf(record), record.wideLength)) {
+                const auto next = static_cast<std::uint32_t>(nodes.size());
+                const auto [it, inserted] = nodes[node].children.try_emplace(c, next);
+                node = it->second;
+                if (inserted) {
+                    nodes.emplace_back();
+                }
+            }
+            nodes[node].pattern = i + 1;
+        }
+
+        trieNodes.reserve(nodes.size());
+        trieEdges.reserve(nodes.size() - 1);
+        for (const auto& node : nodes) {
+            trieNodes.push_back({static_cast<std::uint32_t>(trieEdges.size()),
+                                 static_cast<std::uint32_t>(node.children.size()), node.pattern});
+            for (const auto& [label, child] : node.children) {
+                trieEdges.push_back({label, child});
+            }
+        }
+    }
+
+    std::optional<KeyIndex::Entry> KeyIndex::Find(const wchar_t* a_key) const noexcept {
+        if (!a_key || a_key[0] != L'$' || entryOffsets.empty()) {
+            return std::nullopt;
+        }
+
+        std::size_t len = 1;
+        while (a_key[len]) {
+            if (++len > maxLength) {
+                return std::nullopt;
+            }
+        }
+        if (!(lengthMask[len / 64] & 1ull << (len % 64))) {
+            return std::nullopt;
+        }
+
+        const auto hash = Hash(a_key, len);
+        const auto tag = hash & ~0xFFFFFFFFull;
+        for (auto slot = static_cast<std::size_t>(hash) & slotMask; slots[slot]; slot = (slot + 1) & slotMask) {
+            if ((slots[slot] & ~0xFFFFFFFFull) != tag) {
+                continue;
+            }
+            const auto offset = static_cast<std::uint32_t>(slots[slot] & 0xFFFFFFFFull) - 1;
+            const auto& record = RecordAt(offset);
+            if (record.hash == hash && record.wideLength == len && std::wmemcmp(WideKeyOf(record), a_key, len) == 0) {
+                return EntryAt(offset);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<KeyIndex::Entry> KeyIndex::FindPrefix(const wchar_t* a_key) const noexcept {
+        if (!a_key || trieNodes.empty()) {
+            return std::nullopt;
+        }
+
+        std::uint32_t best = 0;  // pattern index + 1
+        std::uint32_t node = 0;
+        for (std::size_t i = 0;; ++i) {
+            const auto& n = trieNodes[node];
+            if (n.pattern) {
+                best = n.pattern;
+            }
+            if (!a_key[i]) {
+                break;
+            }
+
+            const auto first = trieEdges.begin() + n.firstEdge;
+            const auto last = first + n.edgeCount;
+            const auto it = std::lower_bound(first, last, a_key[i], [](const TrieEdge& a_edge, const wchar_t a_c) {
+                return a_edge.label < a_c;
+            });
+            if (it == last || it->label != a_key[i]) {
+                break;
+            }
+            node = it->child;
+        }
+        if (!best) {
+            return std::nullopt;
+        }
+        return EntryAt(patternOffsets[best - 1]);
+    }
+
+    std::vector<std::pair<std::string_view, std::uint32_t>> KeyIndex::TopKeys(const std::size_t a_count) const {
+        std::vector<std::pair<std::string_view, std::uint32_t>> top;
+        if (!hits) {
+            return top;
+        }
+        const auto add = [&](const Entry& a_entry) {
+            if (const auto n = hits[a_entry.id].load(std::memory_order_relaxed)) {
+                top.emplace_back(a_entry.key, n);
+            }
+        };
+        for (const auto offset : entryOffsets) {
+            add(EntryAt(offset));
+        }
+        for (const auto offset : patternOffsets) {
+            add(EntryAt(offset));
+        }
+        const auto count = std::min(a_count, top.size());
+        std::partial_sort(top.begin(), top.begin() + static_cast<std::ptrdiff_t>(count), top.end(),
+                          [](const auto& a_lhs, const auto& a_rhs) { return a_lhs.second > a_rhs.second; });
+        top.resize(count);
+        return top;
+    }
+
+    std::optional<KeyIndex::Entry> KeyIndex::Find(const std::string_view a_keyUtf8) const {
+        const Text::WideBuffer wideKey(a_keyUtf8, L"$");
+        if (const auto entry = Find(wideKey.c_str())) {
+            return entry;
+        }
+        return FindPrefix(wideKey.c_str());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "Core/NativeBatch.h"
+#include "Core/Async.h"
+#include "Core/Translator.h"
+
+namespace DynamicTranslationSE {
+    std::wstring NativeBatchGroup::Fetch(const std::string_view a_key, ResultCache& a_cache, const Provider& a_prov) {
+        const auto frame = CurrentFrame();
+        std::lock_guard lock(mutex);
+
+        // The requested key goes first, followed by every other key of this DLL that is still on screen
+        const HotKey hot{frame, a_prov.ttl, a_prov.generation, a_prov.memoize};
+        auto self = hotKeys.find(a_key);
+        if (self == hotKeys.end()) {
+            self = hotKeys.emplace(a_key, hot).first;
+        } else {
+            self->second = hot;
+        }
+        batchKeys.clear();
+        batchKeys.push_back(&*self);
+        for (auto it = hotKeys.begin(); it != hotKeys.end();) {
+            if (frame - it->second.frame > kHotFrames) {
+                it = hotKeys.erase(it);
+                continue;
+            }
+            if (it != self && batchKeys.size() < kMaxBatchKeys) {
+                batchKeys.push_back(&*it);
+            }
+            ++it;
+        }
+
+        lastCallFrame = frame;
+        std::wstring own;
+        CallAndStore(a_cache, own);
+        return own;
+    }
+
+    bool NativeBatchGroup::Defer(const std::string_view a_key, const Provider& a_prov) {
+        const auto frame = CurrentFrame();
+        std::lock_guard lock(mutex);
+        if (lastCallFrame != frame) {
+            return false;
+        }
+        const HotKey hot{frame, a_prov.ttl, a_prov.generation, a_prov.memoize, true};
+        if (const auto it = hotKeys.find(a_key); it != hotKeys.end()) {
+            it->second = hot;
+        } else {
+            hotKeys.emplace(a_key, hot);
+        }
+        return true;
+    }
+
+    bool NativeBatchGroup::FlushDeferred(ResultCache& a_cache) {
+        std::lock_guard lock(mutex);
+        bool stored = false;
+        std::wstring first;
+        auto it = hotKeys.begin();
+        while (it != hotKeys.end()) {
+            batchKeys.clear();
+            for (; it != hotKeys.end() && batchKeys.size() < kMaxBatchKeys; ++it) {
+                if (it->second.deferred) {
+                    batchKeys.push_back(&*it);
+                }
+            }
+            if (!batchKeys.empty()) {
+                stored = CallAndStore(a_cache, first) || stored;
+            }
+        }
+        return stored;
+    }
+
+    bool NativeBatchGroup::CallAndStore(ResultCache& a_cache, std::wstring& a_first) {
+        // Taken before the call, so a key invalidated meanwhile is stored under a generation lookups no longer ask
+        // for. The other keys are stored under the generation their next lookup in this frame asks for, not under
+        // the one of their last miss, which for a non-memoized key was a past frame's.
+        keys.clear();
+        generations.clear();
+        for (const auto entry : batchKeys) {
+            auto& [key, keyHot] = *entry;
+            keys.push_back({key.data(), static_cast<std::uint32_t>(key.size())});
+            generations.push_back(NativeResultGeneration(key, keyHot.memoize, keyHot.providerGeneration));
+            // Whatever the call returns, the key no longer waits for a flush
+            keyHot.deferred = false;
+        }
+        results.assign(keys.size(), {0, 0, kDTFNoResult});
+
+        const auto count = static_cast<std::uint32_t>(keys.size());
+        if (!Call(count)) {
+            return false;
+        }
+
+        bool stored = false;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const auto& result = results[i];
+            const auto& [key, hot] = *batchKeys[i];
+            if (result.status == kDTFPending) {
+                // Whatever is cached stays visible until the provider delivers
+                AsyncPool::GetSingleton().MarkPending(key, hot.ttl, generations[i]);
+                continue;
+            }
+            std::wstring_view value;
+            if (result.status == kDTFOk && result.offset <= arenaUsed && result.size <= arenaUsed - result.offset) {
+                value = {arena.data() + result.offset, result.size};
+            }
+            if (i == 0) {
+                a_first = value;
+            }
+            // Keys without a result are cached empty too, so they are not fetched again until the next refresh
+            a_cache.Put(key, value, hot.ttl, generations[i]);
+            stored = true;
+        }
+        return stored;
+    }
+
+    bool NativeBatchGroup::Call(const std::uint32_t a_count) {
+        while (true) {
+            DTFBatchRequest request{DTF_ABI_VERSION, a_count, keys.data(), results.data(),
+                                    arena.data(), static_cast<std::uint32_t>(arena.size()), 0};
+            const auto status = func(&request);
+            if (status == kDTFOk) {
+                arenaUsed = std::min(request.arenaUsed, static_cast<std::uint32_t>(arena.size()));
+                return true;
+            }
+            if (status == kDTFArenaFull && arena.size() < kMaxArena) {
+                arena.resize(arena.size() * 2);
+                continue;
+            }
+            spdlog::error("NativeBatch: Batch of {} keys from '{}' failed (status {})", a_count, dllName, status);
+            return false;
+        }
+    }
+}
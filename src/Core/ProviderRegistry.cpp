@@ -0,0 +1,39 @@
+#include "Core/ProviderRegistry.h"
+#include <thread>
+
+namespace DynamicTranslationSE {
+    ProviderRegistry::ReadGuard::ReadGuard() noexcept {
+        // Register in the slot of the current epoch. If a writer flipped the epoch in between, our slot may
+        // already have been drained, so back out and retry against the new epoch.
+        while (true) {
+            const auto e = epoch.load();
+            slot = static_cast<std::size_t>(e & 1);
+            readers[slot].fetch_add(1);
+            if (epoch.load() == e) {
+                break;
+            }
+            readers[slot].fetch_sub(1);
+        }
+        index = current.load();
+    }
+
+    ProviderRegistry::ReadGuard::~ReadGuard() {
+        readers[slot].fetch_sub(1, std::memory_order_release);
+    }
+
+    void ProviderRegistry::Publish(std::unique_ptr<KeyIndex> a_index) {
+        std::lock_guard lock(writerMutex);
+
+        const auto old = current.exchange(a_index.release());
+
+        // Send new readers to the other slot, then wait for everyone still in the old one
+        const auto oldSlot = static_cast<std::size_t>(epoch.fetch_add(1) & 1);
+        while (readers[oldSlot].load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+
+        if (old != &emptyIndex) {
+            delete old;
+        }
+    }
+}
\ No newline at end of file
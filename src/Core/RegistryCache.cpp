@@ -0,0 +1,182 @@
+#include "Core/RegistryCache.h"
+#include <fstream>
+#include <span>
+
+namespace {
+    // False on a short read
+    bool ReadBytes(std::istream& a_in, const std::span<std::byte> a_bytes) {
+        a_in.read(reinterpret_cast<char*>(a_bytes.data()), static_cast<std::streamsize>(a_bytes.size()));
+        return a_in.gcount() == static_cast<std::streamsize>(a_bytes.size());
+    }
+
+    template <class T>
+    bool ReadRecords(std::istream& a_in, std::vector<T>& a_out, const std::uint32_t a_count) {
+        a_out.resize(a_count);
+        return ReadBytes(a_in, std::as_writable_bytes(std::span(a_out)));
+    }
+
+    template <class T>
+    void WriteRecords(std::ostream& a_out, const std::span<const T> a_records) {
+        const auto bytes = std::as_bytes(a_records);
+        a_out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+namespace DynamicTranslationSE {
+    bool RegistryCache::Read(const std::filesystem::path& a_path, const Manifest& a_manifest, RegistrySpec& a_spec) {
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(a_path, ec);
+        if (ec) {
+            return false;
+        }
+
+        try {
+            std::ifstream in(a_path, std::ios::binary);
+            const auto corrupt = [&] {
+                spdlog::warn("RegistryCache: '{}' is corrupt, rebuilding", a_path.string());
+                return false;
+            };
+
+            Header header{};
+            if (!ReadBytes(in, std::as_writable_bytes(std::span(&header, 1)))) {
+                return corrupt();
+            }
+            if (header.magic != kMagic || header.version != kVersion) {
+                spdlog::info("RegistryCache: '{}' has an unknown format, rebuilding", a_path.string());
+                return false;
+            }
+            if (header.fileCount != a_manifest.size()) {
+                spdlog::info("RegistryCache: Config files changed, rebuilding");
+                return false;
+            }
+            // The counts size every vector below, so they have to add up to the file before anything is allocated
+            const auto expectedSize = sizeof(Header) + std::uint64_t{header.blobSize} +
+                                      std::uint64_t{header.fileCount} * sizeof(FileRecord) +
+                                      std::uint64_t{header.entryCount} * sizeof(EntryRecord) +
+                                      std::uint64_t{header.keyCount} * sizeof(KeyRecord);
+            if (expectedSize != fileSize) {
+                return corrupt();
+            }
+
+            std::vector<char> blob(header.blobSize);
+            if (!ReadBytes(in, std::as_writable_bytes(std::span(blob)))) {
+                return corrupt();
+            }
+            const auto str = [&](const StringRef a_ref) -> std::optional<std::string_view> {
+                if (a_ref.offset > blob.size() || a_ref.size > blob.size() - a_ref.offset) {
+                    return std::nullopt;
+                }
+                return std::string_view(blob.data() + a_ref.offset, a_ref.size);
+            };
+
+            std::vector<FileRecord> files;
+            if (!ReadRecords(in, files, header.fileCount)) {
+                return corrupt();
+            }
+            for (std::size_t i = 0; i < files.size(); ++i) {
+                const auto name = str(files[i].name);
+                const auto& expected = a_manifest[i];
+                if (!name || *name != expected.name || files[i].size != expected.size ||
+                    files[i].mtime != expected.mtime) {
+                    spdlog::info("RegistryCache: Config files changed, rebuilding");
+                    return false;
+                }
+            }
+
+            std::vector<EntryRecord> entries;
+            std::vector<KeyRecord> keys;
+            if (!ReadRecords(in, entries, header.entryCount) || !ReadRecords(in, keys, header.keyCount)) {
+                return corrupt();
+            }
+
+            RegistrySpec spec;
+            spec.entries.reserve(entries.size());
+            for (const auto& record : entries) {
+                const auto dll = str(record.dll);
+                const auto papyrus = str(record.papyrus);
+                const auto rules = str(record.rules);
+                if (!dll || !papyrus || !rules || record.refresh > static_cast<std::uint8_t>(RefreshPolicy::kEvent)) {
+                    return corrupt();
+                }
+                spec.entries.push_back({std::string(*dll), std::string(*papyrus),
+                                        static_cast<RefreshPolicy>(record.refresh), record.refreshIntervalMs,
+                                        record.ttlMs, record.memoize != 0, record.async != 0,
+                                        record.asyncQueueLimit, record.budgetUs, std::string(*rules)});
+            }
+
+            spec.keys.reserve(keys.size());
+            for (const auto& record : keys) {
+                const auto key = str(record.key);
+                if (!key || record.entry >= spec.entries.size()) {
+                    return corrupt();
+                }
+                spec.keys.emplace(*key, record.entry);
+            }
+
+            a_spec = std::move(spec);
+            return true;
+        } catch (const std::exception& e) {
+            spdlog::warn("RegistryCache: Failed to read '{}': {}", a_path.string(), e.what());
+            return false;
+        }
+    }
+
+    void RegistryCache::Write(const std::filesystem::path& a_path, const Manifest& a_manifest,
+                              const RegistrySpec& a_spec) {
+        std::string blob;
+        const auto add = [&](const std::string_view a_str) {
+            const StringRef ref{static_cast<std::uint32_t>(blob.size()), static_cast<std::uint32_t>(a_str.size())};
+            blob.append(a_str);
+            return ref;
+        };
+
+        std::vector<FileRecord> files;
+        files.reserve(a_manifest.size());
+        for (const auto& file : a_manifest) {
+            files.push_back({add(file.name), file.size, file.mtime});
+        }
+
+        std::vector<EntryRecord> entries;
+        entries.reserve(a_spec.entries.size());
+        for (const auto& entry : a_spec.entries) {
+            entries.push_back({add(entry.dll), add(entry.papyrus), add(entry.rules), entry.refreshIntervalMs,
+                               entry.ttlMs, entry.asyncQueueLimit, entry.budgetUs,
+                               static_cast<std::uint8_t>(entry.refresh), static_cast<std::uint8_t>(entry.memoize),
+                               static_cast<std::uint8_t>(entry.async), 0});
+        }
+
+        std::vector<KeyRecord> keys;
+        keys.reserve(a_spec.keys.size());
+        for (const auto& [key, entry] : a_spec.keys) {
+            keys.push_back({add(key), entry});
+        }
+
+        const Header header{kMagic,
+                            kVersion,
+                            static_cast<std::uint32_t>(blob.size()),
+                            static_cast<std::uint32_t>(files.size()),
+                            static_cast<std::uint32_t>(entries.size()),
+                            static_cast<std::uint32_t>(keys.size())};
+
+        // Write to a side file and swap it in, so a crash mid-write never leaves a truncated image behind
+        auto tmpPath = a_path;
+        tmpPath += ".tmp";
+        try {
+            {
+                std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+                out.exceptions(std::ios::failbit | std::ios::badbit);
+                WriteRecords<Header>(out, std::span(&header, 1));
+                out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+                WriteRecords<FileRecord>(out, files);
+                WriteRecords<EntryRecord>(out, entries);
+                WriteRecords<KeyRecord>(out, keys);
+            }
+            std::filesystem::rename(tmpPath, a_path);
+            spdlog::info("RegistryCache: Wrote {} keys to '{}'", keys.size(), a_path.string());
+        } catch (const std::exception& e) {
+            spdlog::warn("RegistryCache: Failed to write '{}': {}", a_path.string(), e.what());
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "Core/ResultCache.h"
+
+namespace DynamicTranslationSE {
+    bool ResultCache::Get(const std::string_view a_key, std::wstring& a_out, const std::uint64_t a_generation) const {
+        std::shared_lock lock(mutex);
+        const auto it = index.find(a_key);
+        if (it == index.end()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const auto& slot = slots[it->second];
+        if (slot.expires <= Clock::now()) {
+            expirations.fetch_add(1, std::memory_order_relaxed);
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (slot.generation != a_generation) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slot.referenced.store(true, std::memory_order_relaxed);
+        hits.fetch_add(1, std::memory_order_relaxed);
+        a_out = slot.value;
+        return true;
+    }
+
+    bool ResultCache::GetLastKnown(const std::string_view a_key, std::wstring& a_out) const {
+        std::shared_lock lock(mutex);
+        const auto it = index.find(a_key);
+        if (it == index.end()) {
+            return false;
+        }
+        a_out = slots[it->second].value;
+        return true;
+    }
+
+    void ResultCache::Put(const std::string_view a_key, const std::wstring_view a_value,
+                          const std::chrono::milliseconds a_ttl, const std::uint64_t a_generation) {
+        const auto expires = a_ttl.count() > 0 ? Clock::now() + a_ttl : Clock::time_point::max();
+
+        std::unique_lock lock(mutex);
+        if (const auto it = index.find(a_key); it != index.end()) {
+            const auto pos = it->second;
+            auto& slot = slots[pos];
+            // Refreshes mostly bring back the same text, which then stays where it is
+            if (slot.value != a_value) {
+                bytes -= EntryBytes(slot.key, slot.value);
+                bytes += EntryBytes(slot.key, a_value);
+                deadBytes += slot.value.size() * sizeof(wchar_t);
+                slot.value = valueArena.Store(a_value);
+            }
+            slot.expires = expires;
+            slot.generation = a_generation;
+            slot.referenced.store(true, std::memory_order_relaxed);
+            // A longer value can push the cache over budget; make room around the entry being updated
+            while (index.size() > 1 && bytes > byteBudget) {
+                EvictOne(pos);
+            }
+            MaybeCompact();
+            return;
+        }
+
+        const auto needed = EntryBytes(a_key, a_value);
+        while (!index.empty() && bytes + needed > byteBudget) {
+            EvictOne();
+        }
+
+        std::size_t pos;
+        if (!freeSlots.empty()) {
+            pos = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            pos = slots.size();
+            slots.emplace_back();
+        }
+
+        auto& slot = slots[pos];
+        slot.key = keyArena.Store(a_key);
+        slot.value = valueArena.Store(a_value);
+        slot.expires = expires;
+        slot.generation = a_generation;
+        slot.referenced.store(false, std::memory_order_relaxed);
+        slot.used = true;
+        index.emplace(slot.key, pos);
+        bytes += needed;
+        MaybeCompact();
+    }
+
+    void ResultCache::MaybeCompact() {
+        constexpr std::size_t kMinDeadBytes = 64 * 1024;
+        if (deadBytes < kMinDeadBytes || deadBytes < bytes - index.size() * kEntryOverhead) {
+            return;
+        }
+
+        StringArena keys;
+        WideStringArena values;
+        for (auto& slot : slots) {
+            if (slot.used) {
+                slot.key = keys.Store(slot.key);
+                slot.value = values.Store(slot.value);
+            }
+        }
+        // The index points into the old key arena
+        index.clear();
+        for (std::size_t pos = 0; pos < slots.size(); ++pos) {
+            if (slots[pos].used) {
+                index.emplace(slots[pos].key, pos);
+            }
+        }
+        keyArena = std::move(keys);
+        valueArena = std::move(values);
+        deadBytes = 0;
+        ++compactions;
+    }
+
+    void ResultCache::EvictOne(const std::size_t a_keep) {
+        // Sweep the clock hand, clearing reference bits, until an unreferenced (or expired) entry turns up
+        const auto now = Clock::now();
+        while (true) {
+            if (hand >= slots.size()) {
+                hand = 0;
+            }
+            const auto pos = hand++;
+            auto& slot = slots[pos];
+            if (!slot.used || pos == a_keep) {
+                continue;
+            }
+            if (slot.expires > now && slot.referenced.exchange(false, std::memory_order_relaxed)) {
+                continue;
+            }
+
+            Release(pos);
+            ++evictions;
+            return;
+        }
+    }
+
+    void ResultCache::Release(const std::size_t a_pos) {
+        auto& slot = slots[a_pos];
+        bytes -= EntryBytes(slot.key, slot.value);
+        deadBytes += TextBytes(slot.key, slot.value);
+        index.erase(slot.key);
+        slot.key = {};
+        slot.value = {};
+        slot.used = false;
+        freeSlots.push_back(a_pos);
+    }
+
+    void ResultCache::Erase(const std::string_view a_key) {
+        std::unique_lock lock(mutex);
+        if (const auto it = index.find(a_key); it != index.end()) {
+            Release(it->second);
+            MaybeCompact();
+        }
+    }
+
+    void ResultCache::Clear() {
+        std::unique_lock lock(mutex);
+        index.clear();
+        slots.clear();
+        freeSlots.clear();
+        hand = 0;
+        bytes = 0;
+        keyArena.Clear();
+        valueArena.Clear();
+        deadBytes = 0;
+    }
+
+    ResultCache::Stats ResultCache::GetStats() const {
+        std::shared_lock lock(mutex);
+        return {hits.load(std::memory_order_relaxed),
+                misses.load(std::memory_order_relaxed),
+                expirations.load(std::memory_order_relaxed),
+                evictions,
+                index.size(),
+                bytes,
+                keyArena.MemoryBytes() + valueArena.MemoryBytes(),
+                compactions};
+    }
+
+    void ResultCache::LogStats(const std::string_view a_name) const {
+        const auto stats = GetStats();
+        spdlog::info("{} cache: {} entries, {} / {} bytes ({} in arenas, {} compactions), {} hits, {} misses, "
+                     "{} expired, {} evicted",
+                     a_name, stats.entries, stats.bytes, byteBudget, stats.arenaBytes, stats.compactions, stats.hits,
+                     stats.misses, stats.expirations, stats.evictions);
+    }
+}
\ No newline at end of file
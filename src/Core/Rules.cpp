@@ -0,0 +1,206 @@
+#include "Core/Rules.h"
+#include <charconv>
+#include "Core/Text.h"
+
+namespace DynamicTranslationSE::Rules {
+    namespace {
+        // Longest float in its shortest round-trip form, e.g. "-1.1754944e-38"
+        constexpr std::size_t kMaxNumberSize = 16;
+
+        std::string_view Trim(std::string_view a_str) {
+            constexpr std::string_view kSpace = " \t";
+            const auto first = a_str.find_first_not_of(kSpace);
+            if (first == std::string_view::npos) {
+                return {};
+            }
+            return a_str.substr(first, a_str.find_last_not_of(kSpace) - first + 1);
+        }
+    }
+
+    std::shared_ptr<const RuleSet> RuleSet::Compile(const std::vector<RuleSource>& a_rules,
+                                                    const OperandResolver& a_resolve, const std::string_view a_owner) {
+        auto set = std::make_shared<RuleSet>();
+        std::string error;
+        for (std::size_t i = 0; i < a_rules.size() && error.empty(); ++i) {
+            const auto& source = a_rules[i];
+            Rule rule{static_cast<std::uint32_t>(set->conditions.size()), 0,
+                      static_cast<std::uint32_t>(set->pieces.size()), 0};
+            for (const auto& condition : source.when) {
+                if (!set->AddCondition(condition, a_resolve, error)) {
+                    break;
+                }
+            }
+            if (error.empty()) {
+                set->AddText(source.text, source.args, a_resolve, error);
+            }
+            if (!error.empty()) {
+                error = fmt::format("rule {}: {}", i + 1, error);
+                break;
+            }
+            rule.conditionCount = static_cast<std::uint32_t>(set->conditions.size()) - rule.firstCondition;
+            rule.pieceCount = static_cast<std::uint32_t>(set->pieces.size()) - rule.firstPiece;
+            set->rules.push_back(rule);
+        }
+
+        if (!error.empty()) {
+            spdlog::error("Rules: Cannot compile the rules of '{}', {}", a_owner, error);
+            return nullptr;
+        }
+        set->operandNames.clear();
+        set->operandNames.shrink_to_fit();
+        return set;
+    }
+
+    std::optional<std::uint16_t> RuleSet::AddOperand(const std::string_view a_reference,
+                                                     const OperandResolver& a_resolve, std::string& a_error) {
+        const auto reference = Trim(a_reference);
+        if (const auto it = std::ranges::find(operandNames, reference); it != operandNames.end()) {
+            return static_cast<std::uint16_t>(it - operandNames.begin());
+        }
+
+        const auto colon = reference.find(':');
+        if (colon == std::string_view::npos) {
+            a_error = fmt::format("operand '{}' is not of the form kind:name", reference);
+            return std::nullopt;
+        }
+        if (operands.size() == kMaxOperands) {
+            a_error = fmt::format("more than {} distinct operands", kMaxOperands);
+            return std::nullopt;
+        }
+        const auto operand = a_resolve(Trim(reference.substr(0, colon)), Trim(reference.substr(colon + 1)));
+        if (!operand || !operand->read) {
+            a_error = fmt::format("unknown operand '{}'", reference);
+            return std::nullopt;
+        }
+
+        operandNames.emplace_back(reference);
+        operands.push_back(*operand);
+        return static_cast<std::uint16_t>(operands.size() - 1);
+    }
+
+    bool RuleSet::AddCondition(const std::string_view a_condition, const OperandResolver& a_resolve,
+                               std::string& a_error) {
+        // Two-character operators first so ">=" is not read as ">"
+        constexpr std::array<std::pair<std::string_view, Op>, 6> kOperators{{{"==", Op::kEq},
+                                                                             {"!=", Op::kNe},
+                                                                             {"<=", Op::kLe},
+                                                                             {">=", Op::kGe},
+                                                                             {"<", Op::kLt},
+                                                                             {">", Op::kGt}}};
+        for (const auto& [token, op] : kOperators) {
+            const auto pos = a_condition.find(token);
+            if (pos == std::string_view::npos) {
+                continue;
+            }
+
+            const auto operand = AddOperand(a_condition.substr(0, pos), a_resolve, a_error);
+            if (!operand) {
+                return false;
+            }
+            const auto literal = Trim(a_condition.substr(pos + token.size()));
+            float value = 0.0f;
+            if (const auto [end, ec] = std::from_chars(literal.data(), literal.data() + literal.size(), value);
+                ec != std::errc{} || end != literal.data() + literal.size()) {
+                a_error = fmt::format("'{}' in condition '{}' is not a number", literal, a_condition);
+                return false;
+            }
+            conditions.push_back({*operand, op, value});
+            return true;
+        }
+        a_error = fmt::format("condition '{}' has no comparison operator", a_condition);
+        return false;
+    }
+
+    bool RuleSet::AddText(const std::string_view a_text, const std::vector<std::string>& a_args,
+                          const OperandResolver& a_resolve, std::string& a_error) {
+        const auto wide = Text::Utf8ToWide(a_text);
+        std::size_t arg = 0;
+        std::size_t literalStart = 0;
+        for (auto pos = wide.find(L"{}"); pos != std::wstring::npos; pos = wide.find(L"{}", literalStart)) {
+            if (arg == a_args.size()) {
+                a_error = fmt::format("text '{}' has more {{}} than args", a_text);
+                return false;
+            }
+            const auto operand = AddOperand(a_args[arg++], a_resolve, a_error);
+            if (!operand) {
+                return false;
+            }
+            pieces.push_back({static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(pos - literalStart),
+                              *operand});
+            text.append(wide, literalStart, pos - literalStart);
+            literalStart = pos + 2;
+        }
+        if (arg != a_args.size()) {
+            a_error = fmt::format("text '{}' has fewer {{}} than args", a_text);
+            return false;
+        }
+        pieces.push_back({static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(wide.size() - literalStart),
+                          Piece::kNoOperand});
+        text.append(wide, literalStart);
+        return true;
+    }
+
+    std::wstring RuleSet::Evaluate() const {
+        std::array<float, kMaxOperands> values;
+        std::uint32_t loaded = 0;
+        const auto read = [&](const std::uint16_t a_operand) {
+            if (!(loaded & (1u << a_operand))) {
+                const auto& operand = operands[a_operand];
+                values[a_operand] = operand.read(operand.context, operand.arg);
+                loaded |= 1u << a_operand;
+            }
+            return values[a_operand];
+        };
+
+        for (const auto& rule : rules) {
+            bool match = true;
+            for (std::uint32_t i = 0; i < rule.conditionCount && match; ++i) {
+                const auto& condition = conditions[rule.firstCondition + i];
+                const auto value = read(condition.operand);
+                switch (condition.op) {
+                case Op::kEq:
+                    match = value == condition.value;
+                    break;
+                case Op::kNe:
+                    match = value != condition.value;
+                    break;
+                case Op::kLt:
+                    match = value < condition.value;
+                    break;
+                case Op::kLe:
+                    match = value <= condition.value;
+                    break;
+                case Op::kGt:
+                    match = value > condition.value;
+                    break;
+                case Op::kGe:
+                    match = value >= condition.value;
+                    break;
+                }
+            }
+            if (!match) {
+                continue;
+            }
+
+            std::size_t size = 0;
+            for (std::uint32_t i = 0; i < rule.pieceCount; ++i) {
+                const auto& piece = pieces[rule.firstPiece + i];
+                size += piece.size + (piece.operand != Piece::kNoOperand ? kMaxNumberSize : 0);
+            }
+            std::wstring result;
+            result.reserve(size);
+            for (std::uint32_t i = 0; i < rule.pieceCount; ++i) {
+                const auto& piece = pieces[rule.firstPiece + i];
+                result.append(text, piece.offset, piece.size);
+                if (piece.operand != Piece::kNoOperand) {
+                    // Shortest round-trip form, so whole numbers print without a fraction
+                    std::array<char, kMaxNumberSize> digits;
+                    const auto end = fmt::format_to_n(digits.data(), digits.size(), "{}", read(piece.operand)).out;
+                    result.append(digits.data(), end);
+                }
+            }
+            return result;
+        }
+        return {};
+    }
+}
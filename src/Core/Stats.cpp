@@ -0,0 +1,173 @@
+#include "Core/Stats.h"
+
+#if DTF_ENABLE_STATS
+    #include <bit>
+    #include <cmath>
+    #include <fstream>
+    #include "Core/CoreSettings.h"
+    #include "Core/ProviderRegistry.h"
+
+namespace {
+    using namespace DynamicTranslationSE::Stats;
+
+    // Bucket i counts durations below 2^i ns; the last one also takes everything longer
+    constexpr std::size_t kBuckets = 40;
+
+    // Written only by its owning thread, so updates are plain relaxed load/store pairs rather than RMW
+    struct Histogram {
+        std::array<std::atomic<std::uint64_t>, kBuckets> buckets{};
+        std::atomic<std::uint64_t> sumNs{0};
+
+        void Add(const std::uint64_t a_ns) {
+            const auto bucket = std::min<std::size_t>(std::bit_width(a_ns), kBuckets - 1);
+            buckets[bucket].store(buckets[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            sumNs.store(sumNs.load(std::memory_order_relaxed) + a_ns, std::memory_order_relaxed);
+        }
+    };
+
+    struct Summary {
+        std::array<std::uint64_t, kBuckets> buckets{};
+        std::uint64_t sumNs{};
+        std::uint64_t count{};
+
+        void Merge(const Histogram& a_histogram) {
+            for (std::size_t i = 0; i < kBuckets; ++i) {
+                const auto n = a_histogram.buckets[i].load(std::memory_order_relaxed);
+                buckets[i] += n;
+                count += n;
+            }
+            sumNs += a_histogram.sumNs.load(std::memory_order_relaxed);
+        }
+
+        // Upper bound of the bucket holding the given quantile
+        [[nodiscard]] std::uint64_t Quantile(const double a_q) const {
+            const auto target = static_cast<std::uint64_t>(std::ceil(a_q * static_cast<double>(count)));
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < kBuckets; ++i) {
+                seen += buckets[i];
+                if (seen >= target && buckets[i]) {
+                    return 1ull << i;
+                }
+            }
+            return 1ull << (kBuckets - 1);
+        }
+    };
+
+    struct ThreadStats {
+        std::array<Histogram, static_cast<std::size_t>(Metric::kTotal)> metrics;
+        std::array<Histogram, kMaxProviders> providers;
+    };
+
+    // Per-thread blocks are never freed, so counts from finished threads stay in the totals
+    std::mutex threadsMutex;
+    std::vector<std::unique_ptr<ThreadStats>> threads;
+
+    std::mutex namesMutex;
+    std::vector<std::string> providerNames{"(unattributed)"};
+
+    ThreadStats& Local() {
+        thread_local ThreadStats* local = [] {
+            auto stats = std::make_unique<ThreadStats>();
+            const auto ptr = stats.get();
+            std::lock_guard lock(threadsMutex);
+            threads.push_back(std::move(stats));
+            return ptr;
+        }();
+        return *local;
+    }
+
+    std::uint64_t ToNs(const Clock::duration a_elapsed) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(a_elapsed).count();
+        return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+    }
+
+    void AppendLine(std::string& a_out, const std::string_view a_name, const Summary& a_summary) {
+        if (!a_summary.count) {
+            return;
+        }
+        a_out += fmt::format("{:<48} calls={:<10} mean={:>9}ns p50<{:>9}ns p99<{:>9}ns max<{:>9}ns\n", a_name,
+                             a_summary.count, a_summary.sumNs / a_summary.count, a_summary.Quantile(0.5),
+                             a_summary.Quantile(0.99), a_summary.Quantile(1.0));
+    }
+}
+
+namespace DynamicTranslationSE::Stats {
+    void Record(const Metric a_metric, const Clock::duration a_elapsed) {
+        Local().metrics[static_cast<std::size_t>(a_metric)].Add(ToNs(a_elapsed));
+    }
+
+    void RecordProvider(const std::uint16_t a_providerId, const Clock::duration a_elapsed) {
+        Local().providers[std::min<std::uint16_t>(a_providerId, kMaxProviders - 1)].Add(ToNs(a_elapsed));
+    }
+
+    std::uint16_t RegisterProvider(const std::string_view a_name) {
+        std::lock_guard lock(namesMutex);
+        for (std::size_t i = 1; i < providerNames.size(); ++i) {
+            if (providerNames[i] == a_name) {
+                return static_cast<std::uint16_t>(i);
+            }
+        }
+        if (providerNames.size() == kMaxProviders - 1) {
+            providerNames.emplace_back("(other providers)");
+        }
+        if (providerNames.size() >= kMaxProviders) {
+            return kMaxProviders - 1;
+        }
+        providerNames.emplace_back(a_name);
+        return static_cast<std::uint16_t>(providerNames.size() - 1);
+    }
+
+    std::string Report() {
+        constexpr std::array<std::string_view, static_cast<std::size_t>(Metric::kTotal)> metricNames{
+            "Translate hook", "Original translate", "Papyrus round trip", "Script lock wait", "Script lookup"};
+
+        std::array<Summary, static_cast<std::size_t>(Metric::kTotal)> metrics{};
+        std::array<Summary, kMaxProviders> providers{};
+        {
+            std::lock_guard lock(threadsMutex);
+            for (const auto& thread : threads) {
+                for (std::size_t i = 0; i < metrics.size(); ++i) {
+                    metrics[i].Merge(thread->metrics[i]);
+                }
+                for (std::size_t i = 0; i < providers.size(); ++i) {
+                    providers[i].Merge(thread->providers[i]);
+                }
+            }
+        }
+
+        std::string out;
+        for (std::size_t i = 0; i < metrics.size(); ++i) {
+            AppendLine(out, metricNames[i], metrics[i]);
+        }
+        {
+            std::lock_guard lock(namesMutex);
+            for (std::size_t i = 0; i < providerNames.size(); ++i) {
+                AppendLine(out, fmt::format("Provider {}", providerNames[i]), providers[i]);
+            }
+        }
+
+        out += "Hottest keys:\n";
+        const ProviderRegistry::ReadGuard registry;
+        for (const auto& [key, hits] : registry->TopKeys(DynamicTranslationFrameworkSE::kStatsTopKeys)) {
+            out += fmt::format("  {:<46} {}\n", key, hits);
+        }
+        return out;
+    }
+
+    void MaybeDump(const std::filesystem::path& a_path) {
+        static Clock::time_point lastDump = Clock::now();
+        const auto now = Clock::now();
+        if (now - lastDump < DynamicTranslationFrameworkSE::kStatsDumpInterval) {
+            return;
+        }
+        lastDump = now;
+
+        std::ofstream ofs(a_path, std::ios::trunc);
+        if (!ofs.is_open()) {
+            spdlog::warn("Stats: Failed to open '{}'", a_path.string());
+            return;
+        }
+        ofs << Report();
+    }
+}
+#endif
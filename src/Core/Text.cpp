@@ -0,0 +1,445 @@
+#include "Core/Text.h"
+#include <cstring>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define DTF_TEXT_X86 1
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define DTF_TARGET_AVX2
+    #else
+        #define DTF_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define DTF_TEXT_X86 0
+#endif
+
+namespace {
+    using namespace DynamicTranslationSE;
+
+    constexpr char32_t kReplacement = 0xFFFD;
+    // Pooled buffers that grew past this are freed when released, so one huge string does not pin memory per thread
+    constexpr std::size_t kMaxRetainedChars = 64 * 1024;
+
+    using WideChar = std::make_unsigned_t<wchar_t>;
+
+    bool IsAscii(const char a_ch) { return static_cast<unsigned char>(a_ch) < 0x80; }
+    bool IsAscii(const wchar_t a_ch) { return static_cast<WideChar>(a_ch) < 0x80; }
+
+    // Whether a kernel should take over at a_pos. A lone ASCII character between others, such as the space between
+    // two words, is cheaper to decode in place than to hand to a kernel.
+    template <class Char>
+    bool AtAsciiRun(const std::basic_string_view<Char> a_text, const std::size_t a_pos) {
+        return IsAscii(a_text[a_pos]) && (a_pos + 1 == a_text.size() || IsAscii(a_text[a_pos + 1]));
+    }
+
+    // Decodes one code point starting at a_utf8[a_pos] and advances a_pos past it
+    char32_t DecodeUtf8(const std::string_view a_utf8, std::size_t& a_pos) {
+        const auto lead = static_cast<unsigned char>(a_utf8[a_pos++]);
+        if (lead < 0x80) {
+            return lead;
+        }
+
+        std::size_t extra;
+        char32_t cp;
+        char32_t min;
+        if ((lead & 0xE0) == 0xC0) {
+            extra = 1;
+            cp = lead & 0x1F;
+            min = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            extra = 2;
+            cp = lead & 0x0F;
+            min = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            extra = 3;
+            cp = lead & 0x07;
+            min = 0x10000;
+        } else {
+            return kReplacement;
+        }
+
+        for (std::size_t i = 0; i < extra; ++i) {
+            if (a_pos >= a_utf8.size() || (static_cast<unsigned char>(a_utf8[a_pos]) & 0xC0) != 0x80) {
+                return kReplacement;
+            }
+            cp = cp << 6 | (static_cast<unsigned char>(a_utf8[a_pos++]) & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return kReplacement;
+        }
+        return cp;
+    }
+
+    // Decodes one code point starting at a_wide[a_pos], combining a UTF-16 surrogate pair, and advances a_pos past it
+    char32_t DecodeWide(const std::wstring_view a_wide, std::size_t& a_pos) {
+        auto cp = static_cast<char32_t>(static_cast<WideChar>(a_wide[a_pos++]));
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (cp >= 0xD800 && cp <= 0xDBFF && a_pos < a_wide.size() && a_wide[a_pos] >= 0xDC00 &&
+                a_wide[a_pos] <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<char32_t>(a_wide[a_pos++]) - 0xDC00);
+            }
+        }
+        if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            return kReplacement;
+        }
+        return cp;
+    }
+
+    wchar_t* EncodeWide(const char32_t a_cp, wchar_t* a_out) {
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (a_cp >= 0x10000) {
+                const auto v = a_cp - 0x10000;
+                *a_out++ = static_cast<wchar_t>(0xD800 + (v >> 10));
+                *a_out++ = static_cast<wchar_t>(0xDC00 + (v & 0x3FF));
+                return a_out;
+            }
+        }
+        *a_out++ = static_cast<wchar_t>(a_cp);
+        return a_out;
+    }
+
+    char* EncodeUtf8(const char32_t a_cp, char* a_out) {
+        if (a_cp < 0x80) {
+            *a_out++ = static_cast<char>(a_cp);
+        } else if (a_cp < 0x800) {
+            *a_out++ = static_cast<char>(0xC0 | a_cp >> 6);
+            *a_out++ = static_cast<char>(0x80 | (a_cp & 0x3F));
+        } else if (a_cp < 0x10000) {
+            *a_out++ = static_cast<char>(0xE0 | a_cp >> 12);
+            *a_out++ = static_cast<char>(0x80 | (a_cp >> 6 & 0x3F));
+            *a_out++ = static_cast<char>(0x80 | (a_cp & 0x3F));
+        } else {
+            *a_out++ = static_cast<char>(0xF0 | a_cp >> 18);
+            *a_out++ = static_cast<char>(0x80 | (a_cp >> 12 & 0x3F));
+            *a_out++ = static_cast<char>(0x80 | (a_cp >> 6 & 0x3F));
+            *a_out++ = static_cast<char>(0x80 | (a_cp & 0x3F));
+        }
+        return a_out;
+    }
+
+    // ASCII kernels: copy the leading run of ASCII from a_in to a_out and return its length
+
+    std::size_t WidenAsciiScalar(const char* a_in, const std::size_t a_size, wchar_t* a_out) {
+        std::size_t i = 0;
+        // Eight bytes at a time while no high bit is set
+        for (; i + 8 <= a_size; i += 8) {
+            std::uint64_t block;
+            std::memcpy(&block, a_in + i, sizeof(block));
+            if (block & 0x8080808080808080ull) {
+                break;
+            }
+            for (std::size_t j = 0; j < 8; ++j) {
+                a_out[i + j] = static_cast<wchar_t>(a_in[i + j]);
+            }
+        }
+        for (; i < a_size && IsAscii(a_in[i]); ++i) {
+            a_out[i] = static_cast<wchar_t>(a_in[i]);
+        }
+        return i;
+    }
+
+    std::size_t NarrowAsciiScalar(const wchar_t* a_in, const std::size_t a_size, char* a_out) {
+        // Every bit but the low seven of each wchar_t in a 64-bit word
+        constexpr auto kMask = sizeof(wchar_t) == 2 ? 0xFF80FF80FF80FF80ull : 0xFFFFFF80FFFFFF80ull;
+        constexpr std::size_t kStep = sizeof(std::uint64_t) / sizeof(wchar_t);
+        std::size_t i = 0;
+        for (; i + kStep <= a_size; i += kStep) {
+            std::uint64_t block;
+            std::memcpy(&block, a_in + i, sizeof(block));
+            if (block & kMask) {
+                break;
+            }
+            for (std::size_t j = 0; j < kStep; ++j) {
+                a_out[i + j] = static_cast<char>(a_in[i + j]);
+            }
+        }
+        for (; i < a_size && IsAscii(a_in[i]); ++i) {
+            a_out[i] = static_cast<char>(a_in[i]);
+        }
+        return i;
+    }
+
+#if DTF_TEXT_X86
+    std::size_t WidenAsciiSse2(const char* a_in, const std::size_t a_size, wchar_t* a_out) {
+        const auto zero = _mm_setzero_si128();
+        std::size_t i = 0;
+        for (; i + 16 <= a_size; i += 16) {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_in + i));
+            if (_mm_movemask_epi8(bytes)) {
+                break;
+            }
+            const auto lo = _mm_unpacklo_epi8(bytes, zero);
+            const auto hi = _mm_unpackhi_epi8(bytes, zero);
+            const auto out = reinterpret_cast<__m128i*>(a_out + i);
+            if constexpr (sizeof(wchar_t) == 2) {
+                _mm_storeu_si128(out, lo);
+                _mm_storeu_si128(out + 1, hi);
+            } else {
+                _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+            }
+        }
+        return i + WidenAsciiScalar(a_in + i, a_size - i, a_out + i);
+    }
+
+    std::size_t NarrowAsciiSse2(const wchar_t* a_in, const std::size_t a_size, char* a_out) {
+        const auto zero = _mm_setzero_si128();
+        std::size_t i = 0;
+        for (; i + 16 <= a_size; i += 16) {
+            const auto in = reinterpret_cast<const __m128i*>(a_in + i);
+            __m128i packed;
+            if constexpr (sizeof(wchar_t) == 2) {
+                const auto a = _mm_loadu_si128(in);
+                const auto b = _mm_loadu_si128(in + 1);
+                const auto high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+                    break;
+                }
+                packed = _mm_packus_epi16(a, b);
+            } else {
+                const auto a = _mm_loadu_si128(in);
+                const auto b = _mm_loadu_si128(in + 1);
+                const auto c = _mm_loadu_si128(in + 2);
+                const auto d = _mm_loadu_si128(in + 3);
+                const auto high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)),
+                                                _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) {
+                    break;
+                }
+                packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(a_out + i), packed);
+        }
+        return i + NarrowAsciiScalar(a_in + i, a_size - i, a_out + i);
+    }
+
+    DTF_TARGET_AVX2 std::size_t WidenAsciiAvx2(const char* a_in, const std::size_t a_size, wchar_t* a_out) {
+        std::size_t i = 0;
+        for (; i + 32 <= a_size; i += 32) {
+            const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_in + i));
+            if (_mm256_movemask_epi8(bytes)) {
+                break;
+            }
+            const auto out = reinterpret_cast<__m256i*>(a_out + i);
+            if constexpr (sizeof(wchar_t) == 2) {
+                _mm256_storeu_si256(out, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+                _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+            } else {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    const auto eight = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a_in + i + j * 8));
+                    _mm256_storeu_si256(out + j, _mm256_cvtepu8_epi32(eight));
+                }
+            }
+        }
+        // The SSE2 tail is not VEX-encoded; mixing it with dirty upper YMM halves stalls on many CPUs
+        _mm256_zeroupper();
+        return i + WidenAsciiSse2(a_in + i, a_size - i, a_out + i);
+    }
+
+    DTF_TARGET_AVX2 std::size_t NarrowAsciiAvx2(const wchar_t* a_in, const std::size_t a_size, char* a_out) {
+        std::size_t i = 0;
+        for (; i + 32 <= a_size; i += 32) {
+            const auto in = reinterpret_cast<const __m256i*>(a_in + i);
+            __m256i packed;
+            if constexpr (sizeof(wchar_t) == 2) {
+                const auto a = _mm256_loadu_si256(in);
+                const auto b = _mm256_loadu_si256(in + 1);
+                if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_set1_epi16(static_cast<short>(0xFF80)))) {
+                    break;
+                }
+                // Packing works per 128-bit lane; the permute puts the lanes back in order
+                packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            } else {
+                const auto a = _mm256_loadu_si256(in);
+                const auto b = _mm256_loadu_si256(in + 1);
+                const auto c = _mm256_loadu_si256(in + 2);
+                const auto d = _mm256_loadu_si256(in + 3);
+                if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)),
+                                        _mm256_set1_epi32(static_cast<int>(0xFFFFFF80)))) {
+                    break;
+                }
+                const auto bytes = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+                packed = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a_out + i), packed);
+        }
+        _mm256_zeroupper();
+        return i + NarrowAsciiSse2(a_in + i, a_size - i, a_out + i);
+    }
+
+    bool CpuHasAvx2() {
+    #ifdef _MSC_VER
+        std::array<int, 4> regs{};
+        __cpuid(regs.data(), 0);
+        if (regs[0] < 7) {
+            return false;
+        }
+        // AVX2 also needs the OS to save the YMM registers
+        __cpuid(regs.data(), 1);
+        if (!(regs[2] & 1 << 27) || !(regs[2] & 1 << 28) || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+        __cpuidex(regs.data(), 7, 0);
+        return regs[1] & 1 << 5;
+    #else
+        // May run from a static constructor, before libgcc has filled in the CPU model
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    #endif
+    }
+#endif
+
+    struct Kernels {
+        Text::Kernel kind;
+        std::size_t (*widen)(const char*, std::size_t, wchar_t*);
+        std::size_t (*narrow)(const wchar_t*, std::size_t, char*);
+    };
+
+    constexpr std::array kKernels{
+        Kernels{Text::Kernel::kScalar, WidenAsciiScalar, NarrowAsciiScalar},
+#if DTF_TEXT_X86
+        Kernels{Text::Kernel::kSse2, WidenAsciiSse2, NarrowAsciiSse2},
+        Kernels{Text::Kernel::kAvx2, WidenAsciiAvx2, NarrowAsciiAvx2},
+#endif
+    };
+
+    const Kernels* FindKernel(const Text::Kernel a_kernel) {
+        const auto it = std::ranges::find(kKernels, a_kernel, &Kernels::kind);
+        if (it == kKernels.end()) {
+            return nullptr;
+        }
+#if DTF_TEXT_X86
+        static const bool hasAvx2 = CpuHasAvx2();
+        if (a_kernel == Text::Kernel::kAvx2 && !hasAvx2) {
+            return nullptr;
+        }
+#endif
+        return &*it;
+    }
+
+    std::atomic<const Kernels*>& ActiveKernels() {
+        static std::atomic<const Kernels*> active{[] {
+            for (auto it = kKernels.rbegin(); it != kKernels.rend(); ++it) {
+                if (const auto kernels = FindKernel(it->kind)) {
+                    return kernels;
+                }
+            }
+            return &kKernels.front();
+        }()};
+        return active;
+    }
+
+    // Strings lent to WideBuffer and Utf8Buffer. Buffers on one thread nest strictly, so the pool is a stack indexed
+    // by nesting depth; each string is allocated on its own so growing the pool does not move the ones lent out.
+    template <class String>
+    class BufferPool {
+    public:
+        String& Acquire() {
+            if (depth == strings.size()) {
+                strings.push_back(std::make_unique<String>());
+            }
+            auto& string = *strings[depth++];
+            string.clear();
+            return string;
+        }
+
+        void Release() {
+            auto& string = *strings[--depth];
+            if (string.capacity() > kMaxRetainedChars) {
+                String().swap(string);
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<String>> strings;
+        std::size_t depth{0};
+    };
+
+    thread_local BufferPool<std::wstring> widePool;
+    thread_local BufferPool<std::string> utf8Pool;
+}
+
+namespace DynamicTranslationSE::Text {
+    void AppendWide(std::wstring& a_out, const std::string_view a_utf8) {
+        // A code point never takes more UTF-16 units (or UTF-32 code points) than it took bytes, and every invalid
+        // sequence of bytes becomes a single U+FFFD, so the byte count bounds the output
+        const auto start = a_out.size();
+        a_out.resize_and_overwrite(start + a_utf8.size(), [&](wchar_t* a_buf, std::size_t) {
+            const auto widen = ActiveKernels().load(std::memory_order_relaxed)->widen;
+            auto out = a_buf + start;
+            std::size_t pos = 0;
+            while (pos < a_utf8.size()) {
+                const auto run = widen(a_utf8.data() + pos, a_utf8.size() - pos, out);
+                pos += run;
+                out += run;
+                while (pos < a_utf8.size() && !AtAsciiRun(a_utf8, pos)) {
+                    out = EncodeWide(DecodeUtf8(a_utf8, pos), out);
+                }
+            }
+            return static_cast<std::size_t>(out - a_buf);
+        });
+    }
+
+    void AppendUtf8(std::string& a_out, const std::wstring_view a_wide) {
+        // At most three bytes per UTF-16 unit (a surrogate pair makes four from two) or four per UTF-32 code point
+        constexpr std::size_t kMaxBytes = sizeof(wchar_t) == 2 ? 3 : 4;
+        const auto start = a_out.size();
+        a_out.resize_and_overwrite(start + a_wide.size() * kMaxBytes, [&](char* a_buf, std::size_t) {
+            const auto narrow = ActiveKernels().load(std::memory_order_relaxed)->narrow;
+            auto out = a_buf + start;
+            std::size_t pos = 0;
+            while (pos < a_wide.size()) {
+                const auto run = narrow(a_wide.data() + pos, a_wide.size() - pos, out);
+                pos += run;
+                out += run;
+                while (pos < a_wide.size() && !AtAsciiRun(a_wide, pos)) {
+                    out = EncodeUtf8(DecodeWide(a_wide, pos), out);
+                }
+            }
+            return static_cast<std::size_t>(out - a_buf);
+        });
+    }
+
+    std::wstring Utf8ToWide(const std::string_view a_utf8) {
+        std::wstring out;
+        AppendWide(out, a_utf8);
+        return out;
+    }
+
+    std::string WideToUtf8(const std::wstring_view a_wide) {
+        // Converted in the thread's buffer first, so the returned string is not sized for the worst case
+        const Utf8Buffer utf8(a_wide);
+        return std::string(utf8.view());
+    }
+
+    std::string WideToUtf8(const wchar_t* a_wide) {
+        return a_wide ? WideToUtf8(std::wstring_view(a_wide)) : std::string();
+    }
+
+    WideBuffer::WideBuffer(const std::string_view a_utf8, const std::wstring_view a_prefix) :
+        text(widePool.Acquire()) {
+        text.append(a_prefix);
+        AppendWide(text, a_utf8);
+    }
+
+    WideBuffer::~WideBuffer() { widePool.Release(); }
+
+    Utf8Buffer::Utf8Buffer(const std::wstring_view a_wide) : text(utf8Pool.Acquire()) { AppendUtf8(text, a_wide); }
+
+    Utf8Buffer::~Utf8Buffer() { utf8Pool.Release(); }
+
+    Kernel ActiveKernel() noexcept { return ActiveKernels().load(std::memory_order_relaxed)->kind; }
+
+    bool UseKernel(const Kernel a_kernel) noexcept {
+        const auto kernels = FindKernel(a_kernel);
+        if (!kernels) {
+            return false;
+        }
+        ActiveKernels().store(kernels, std::memory_order_relaxed);
+        return true;
+    }
+}
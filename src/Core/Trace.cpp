@@ -0,0 +1,306 @@
+#include "Core/Trace.h"
+#include <bit>
+#include <condition_variable>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <thread>
+#include "Core/CoreSettings.h"
+#include "Core/Text.h"
+
+namespace {
+    using namespace DynamicTranslationSE::Trace;
+    using Clock = std::chrono::steady_clock;
+    using DynamicTranslationFrameworkSE::kTraceRingRecords;
+
+    static_assert(std::has_single_bit(kTraceRingRecords));
+
+    // Written by its owning thread, drained by the writer thread
+    struct Ring {
+        std::array<CallRecord, kTraceRingRecords> records{};
+        alignas(64) std::atomic<std::uint64_t> head{0};
+        alignas(64) std::atomic<std::uint64_t> tail{0};
+        std::uint16_t thread{};
+    };
+
+    struct WideHash {
+        using is_transparent = void;
+        std::size_t operator()(const std::wstring_view a_str) const noexcept {
+            return std::hash<std::wstring_view>{}(a_str);
+        }
+    };
+
+    struct ThreadState {
+        Ring* ring{};
+        std::uint64_t session{};
+        std::unordered_map<std::wstring, std::uint32_t, WideHash, std::equal_to<>> keyIds;
+    };
+
+    // Rings are never freed, so a thread that exits mid-capture cannot leave the writer with a dangling pointer
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    std::mutex keysMutex;
+    std::vector<std::pair<std::uint32_t, std::string>> pendingKeys;
+    std::atomic<std::uint32_t> nextKeyId{0};
+
+    std::atomic<std::uint64_t> session{0};
+    std::atomic<std::int64_t> startNs{0};
+    std::atomic<std::uint64_t> dropped{0};
+
+    std::mutex controlMutex;
+    std::ofstream file;
+    std::thread writer;
+    std::uint64_t written{0};
+
+    std::mutex writerMutex;
+    std::condition_variable writerSignal;
+    bool stopRequested{false};
+
+    std::int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    ThreadState& Local() {
+        thread_local ThreadState state = [] {
+            auto ring = std::make_unique<Ring>();
+            ThreadState local;
+            local.ring = ring.get();
+            std::lock_guard lock(ringsMutex);
+            ring->thread = static_cast<std::uint16_t>(rings.size());
+            rings.push_back(std::move(ring));
+            return local;
+        }();
+        return state;
+    }
+
+    template <class T>
+    void WriteRaw(const std::span<const T> a_data) {
+        file.write(reinterpret_cast<const char*>(a_data.data()), static_cast<std::streamsize>(a_data.size_bytes()));
+    }
+
+    // Runs on the writer thread, and once more on the stopping thread after the writer has exited
+    void Drain(std::vector<CallRecord>& a_buffer) {
+        std::vector<std::pair<std::uint32_t, std::string>> keys;
+        {
+            std::lock_guard lock(keysMutex);
+            keys.swap(pendingKeys);
+        }
+        if (!keys.empty()) {
+            const BlockHeader header{BlockType::kKeys, static_cast<std::uint32_t>(keys.size())};
+            WriteRaw(std::span(&header, 1));
+            for (const auto& [id, key] : keys) {
+                const KeyDefinition definition{id, static_cast<std::uint32_t>(key.size())};
+                WriteRaw(std::span(&definition, 1));
+                WriteRaw(std::span(key));
+            }
+        }
+
+        std::vector<Ring*> snapshot;
+        {
+            std::lock_guard lock(ringsMutex);
+            for (const auto& ring : rings) {
+                snapshot.push_back(ring.get());
+            }
+        }
+        for (const auto ring : snapshot) {
+            const auto tail = ring->tail.load(std::memory_order_relaxed);
+            const auto head = ring->head.load(std::memory_order_acquire);
+            if (head == tail) {
+                continue;
+            }
+            a_buffer.clear();
+            for (auto i = tail; i != head; ++i) {
+                a_buffer.push_back(ring->records[i & (kTraceRingRecords - 1)]);
+            }
+            ring->tail.store(head, std::memory_order_release);
+
+            const BlockHeader header{BlockType::kRecords, static_cast<std::uint32_t>(a_buffer.size())};
+            WriteRaw(std::span(&header, 1));
+            WriteRaw(std::span<const CallRecord>(a_buffer));
+            written += a_buffer.size();
+        }
+    }
+
+    void WriterLoop() {
+        std::vector<CallRecord> buffer;
+        buffer.reserve(kTraceRingRecords);
+        std::unique_lock lock(writerMutex);
+        while (!stopRequested) {
+            writerSignal.wait_for(lock, DynamicTranslationFrameworkSE::kTraceFlushInterval,
+                                  [] { return stopRequested; });
+            lock.unlock();
+            Drain(buffer);
+            lock.lock();
+        }
+    }
+}
+
+namespace DynamicTranslationSE::Trace {
+    bool Start(const std::filesystem::path& a_path) {
+        std::lock_guard control(controlMutex);
+        if (detail::recording.load()) {
+            spdlog::warn("Trace: A capture is already running");
+            return false;
+        }
+
+        file.open(a_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            spdlog::warn("Trace: Failed to open '{}'", a_path.string());
+            return false;
+        }
+        constexpr FileHeader header{kMagic, kVersion};
+        WriteRaw(std::span(&header, 1));
+
+        // Leftovers from a previous capture would refer to key ids of that session
+        {
+            std::lock_guard lock(ringsMutex);
+            for (const auto& ring : rings) {
+                ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+            }
+        }
+        {
+            std::lock_guard lock(keysMutex);
+            pendingKeys.clear();
+        }
+        session.fetch_add(1, std::memory_order_relaxed);
+        nextKeyId.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        written = 0;
+        startNs.store(NowNs(), std::memory_order_relaxed);
+
+        stopRequested = false;
+        writer = std::thread(WriterLoop);
+        detail::recording.store(true, std::memory_order_release);
+        spdlog::info("Trace: Capturing translate calls to '{}'", a_path.string());
+        return true;
+    }
+
+    void Stop() {
+        std::lock_guard control(controlMutex);
+        if (!detail::recording.exchange(false)) {
+            return;
+        }
+
+        {
+            std::lock_guard lock(writerMutex);
+            stopRequested = true;
+        }
+        writerSignal.notify_one();
+        writer.join();
+
+        std::vector<CallRecord> buffer;
+        Drain(buffer);
+        file.close();
+        spdlog::info("Trace: Capture stopped, {} calls written, {} dropped", written,
+                     dropped.load(std::memory_order_relaxed));
+    }
+
+    void Record(const wchar_t* a_key, const ProviderKind a_provider, const std::uint8_t a_flags,
+                const std::chrono::steady_clock::duration a_latency) {
+        if (!a_key || !detail::recording.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        auto& local = Local();
+        if (const auto current = session.load(std::memory_order_relaxed); local.session != current) {
+            local.keyIds.clear();
+            local.session = current;
+        }
+
+        std::uint32_t keyId;
+        if (const auto it = local.keyIds.find(std::wstring_view(a_key)); it != local.keyIds.end()) {
+            keyId = it->second;
+        } else {
+            keyId = nextKeyId.fetch_add(1, std::memory_order_relaxed);
+            local.keyIds.emplace(a_key, keyId);
+            std::lock_guard lock(keysMutex);
+            pendingKeys.emplace_back(keyId, Text::WideToUtf8(a_key));
+        }
+
+        auto& ring = *local.ring;
+        const auto head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) >= kTraceRingRecords) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        constexpr std::int64_t kMaxLatency = std::numeric_limits<std::uint32_t>::max();
+        const auto latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(a_latency).count();
+        ring.records[head & (kTraceRingRecords - 1)] = {
+            static_cast<std::uint64_t>(std::max<std::int64_t>(NowNs() - startNs.load(std::memory_order_relaxed), 0)),
+            keyId,
+            static_cast<std::uint32_t>(std::clamp<std::int64_t>(latencyNs, 0, kMaxLatency)),
+            ring.thread,
+            a_provider,
+            a_flags,
+            0};
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    bool Load(const std::filesystem::path& a_path, Capture& a_capture) {
+        std::error_code ec;
+        std::uint64_t remaining = std::filesystem::file_size(a_path, ec);
+        std::ifstream in(a_path, std::ios::binary);
+        const auto read = [&](void* a_out, const std::size_t a_size) {
+            in.read(static_cast<char*>(a_out), static_cast<std::streamsize>(a_size));
+            const auto got = static_cast<std::size_t>(in.gcount());
+            remaining -= std::min<std::uint64_t>(got, remaining);
+            return got == a_size;
+        };
+
+        FileHeader header{};
+        if (ec || !in.is_open() || !read(&header, sizeof(header)) || header.magic != kMagic ||
+            header.version != kVersion) {
+            spdlog::warn("Trace: '{}' is not a trace file", a_path.string());
+            return false;
+        }
+
+        Capture capture;
+        BlockHeader block{};
+        bool intact = true;
+        // Counts are checked against the bytes left in the file before they size anything, so a corrupt block
+        // header ends the load instead of allocating gigabytes
+        while (intact && read(&block, sizeof(block))) {
+            if (block.type == BlockType::kKeys) {
+                intact = std::uint64_t{block.count} * sizeof(KeyDefinition) <= remaining;
+                for (std::uint32_t i = 0; intact && i < block.count; ++i) {
+                    KeyDefinition definition{};
+                    std::string key;
+                    intact = read(&definition, sizeof(definition)) && definition.size <= remaining;
+                    if (intact) {
+                        key.resize(definition.size);
+                        intact = read(key.data(), key.size());
+                    }
+                    if (intact) {
+                        capture.keys.insert_or_assign(definition.id, std::move(key));
+                    }
+                }
+            } else if (block.type == BlockType::kRecords) {
+                intact = std::uint64_t{block.count} * sizeof(CallRecord) <= remaining;
+                if (intact) {
+                    const auto offset = capture.records.size();
+                    capture.records.resize(offset + block.count);
+                    intact = read(capture.records.data() + offset, block.count * sizeof(CallRecord));
+                    if (!intact) {
+                        capture.records.resize(offset);
+                    }
+                }
+            } else {
+                intact = false;
+            }
+        }
+        if (!intact) {
+            spdlog::warn("Trace: '{}' is truncated or corrupt, keeping what was read", a_path.string());
+        }
+
+        std::erase_if(capture.records,
+                      [&](const CallRecord& a_record) { return !capture.keys.contains(a_record.keyId); });
+        std::stable_sort(capture.records.begin(), capture.records.end(),
+                         [](const CallRecord& a_lhs, const CallRecord& a_rhs) {
+                             return a_lhs.timestampNs < a_rhs.timestampNs;
+                         });
+        a_capture = std::move(capture);
+        return true;
+    }
+}
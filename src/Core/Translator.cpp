@@ -0,0 +1,660 @@
+#include "Core/Translator.h"
+#include <cstring>
+#include "Core/Async.h"
+#include "Core/CircuitBreaker.h"
+#include "Core/CoreSettings.h"
+#include "Core/LazyProvider.h"
+#include "Core/NativeBatch.h"
+#include "Core/ProviderRegistry.h"
+#include "Core/ResultCache.h"
+#include "Core/Rules.h"
+#include "Core/Stats.h"
+#include "Core/Text.h"
+
+namespace {
+    using DynamicTranslationSE::AsyncPool;
+    using DynamicTranslationSE::StringHash;
+
+    DynamicTranslationSE::TranslationHost* host = nullptr;
+
+    DynamicTranslationSE::ResultCache papyrusResults{DynamicTranslationFrameworkSE::kPapyrusResultCacheBytes};
+    DynamicTranslationSE::ResultCache nativeResults{DynamicTranslationFrameworkSE::kNativeResultCacheBytes};
+
+    // Bumped by InvalidateAll; mixed into the generation of every memoized native result
+    std::atomic<std::uint64_t> nativeGeneration{1};
+    // Bumped per key by InvalidateKey and mixed into that key's generation, so a call that was already running
+    // stores its result under a generation later lookups no longer ask for. Reset by InvalidateAll.
+    std::shared_mutex keyStampMutex;
+    std::unordered_map<std::string, std::uint64_t, StringHash, std::equal_to<>> keyStamps;
+    std::atomic_bool hasKeyStamps{false};
+
+    std::uint64_t NativeGeneration(const DynamicTranslationSE::Provider& prov, const std::string_view a_key) {
+        return DynamicTranslationSE::NativeResultGeneration(a_key, prov.memoize, prov.generation);
+    }
+
+    std::wstring CallNative(const DynamicTranslationSE::Provider& prov, const std::string_view a_key) {
+        if (!prov.native) {
+            return {};
+        }
+        const auto result = prov.native(a_key);
+        return result ? std::wstring(result) : std::wstring{};
+    }
+    std::atomic_bool hasUnregisteredResults{false};
+
+    std::string_view ProviderName(const DynamicTranslationSE::Provider& prov) {
+        return prov.breaker ? std::string_view(prov.breaker->Name()) : std::string_view("unnamed provider");
+    }
+
+    // Synchronous provider time spent in the current frame
+    std::atomic<std::uint64_t> budgetFrame{~0ull};
+    std::atomic<std::int64_t> frameSpentNs{0};
+    std::atomic<std::uint64_t> deferredCalls{0};
+
+    // Whether a synchronous call may run now. The frame budget is checked first so a breaker never hands out a
+    // probe that is then not made.
+    bool AdmitCall(const DynamicTranslationSE::Provider& prov) {
+        using namespace DynamicTranslationFrameworkSE;
+        if (const auto frame = DynamicTranslationSE::CurrentFrame();
+            budgetFrame.load(std::memory_order_relaxed) != frame) {
+            budgetFrame.store(frame, std::memory_order_relaxed);
+            frameSpentNs.store(0, std::memory_order_relaxed);
+        } else if (frameSpentNs.load(std::memory_order_relaxed) >=
+                   std::chrono::nanoseconds(kFrameProviderBudget).count()) {
+            deferredCalls.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return !prov.breaker || prov.breaker->Allow();
+    }
+
+    // Runs an admitted provider call, charging its time to the frame (if a_chargeFrame) and reporting it against
+    // a_budget. Returns nothing when the provider threw.
+    template <class Call>
+    std::optional<std::wstring> GuardedCall(const DynamicTranslationSE::Provider& prov, const std::string_view a_key,
+                                            const std::chrono::steady_clock::duration a_budget,
+                                            const bool a_chargeFrame, Call&& a_call) {
+        const auto start = std::chrono::steady_clock::now();
+        std::optional<std::wstring> result;
+        std::string failure;
+        try {
+            result = a_call();
+        } catch (const std::exception& e) {
+            failure = fmt::format("threw '{}'", e.what());
+        } catch (...) {
+            failure = "threw an exception";
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (a_chargeFrame) {
+            frameSpentNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                   std::memory_order_relaxed);
+        }
+        if (!failure.empty()) {
+            spdlog::error("Provider '{}' {} for key '{}'", ProviderName(prov), failure, a_key);
+            if (prov.breaker) {
+                prov.breaker->Fail(failure);
+            }
+            return std::nullopt;
+        }
+        if (prov.breaker) {
+            prov.breaker->Report(elapsed, a_budget);
+        }
+        return result;
+    }
+
+    // Async jobs write with the generation of the translate that submitted them, and only ask for a refresh when
+    // the text changed, so providers that are not memoized do not re-translate the menu forever
+    void StoreNativeResult(const std::string_view a_key, const std::wstring_view a_result,
+                           const std::chrono::milliseconds a_ttl, const std::uint64_t a_generation) {
+        std::wstring previous;
+        const bool changed = !nativeResults.GetLastKnown(a_key, previous) || previous != a_result;
+        nativeResults.Put(a_key, a_result, a_ttl, a_generation);
+        if (changed && host) {
+            host->RequestRefresh();
+        }
+    }
+
+    // Never blocks: serves the last known text and leaves the provider call to a worker
+    std::wstring InvokeAsync(const DynamicTranslationSE::Provider& prov, const std::string_view a_key,
+                             const std::uint64_t a_generation) {
+        std::wstring result;
+        nativeResults.GetLastKnown(a_key, result);
+        std::string key(a_key);
+        AsyncPool::GetSingleton().Submit(*prov.async, key, [prov, a_key = std::move(key), a_generation] {
+            // Workers do not spend frame time, so only calls that outlast a pending request count as overruns
+            if (prov.breaker && !prov.breaker->Allow()) {
+                return;
+            }
+            constexpr auto kBudget = DynamicTranslationFrameworkSE::kAsyncPendingTimeout;
+            if (prov.batch) {
+                std::wstring previous, current;
+                nativeResults.GetLastKnown(a_key, previous);
+                GuardedCall(prov, a_key, kBudget, false,
+                            [&] { return prov.batch->Fetch(a_key, nativeResults, prov); });
+                // Keys answered as pending refresh once CompleteNativeRequest delivers them
+                if (nativeResults.GetLastKnown(a_key, current) && current != previous && host) {
+                    host->RequestRefresh();
+                }
+                return;
+            }
+            if (auto result = GuardedCall(prov, a_key, kBudget, false, [&] { return CallNative(prov, a_key); })) {
+                StoreNativeResult(a_key, *result, prov.ttl, a_generation);
+            }
+        });
+        return result;
+    }
+
+    // Batch providers with keys left for FlushNativeBatches, one per DLL
+    std::mutex deferredBatchMutex;
+    std::vector<DynamicTranslationSE::Provider> deferredBatches;
+
+    void QueueBatchFlush(const DynamicTranslationSE::Provider& prov) {
+        std::lock_guard lk(deferredBatchMutex);
+        if (std::ranges::none_of(deferredBatches, [&](const auto& a_queued) { return a_queued.batch == prov.batch; })) {
+            deferredBatches.push_back(prov);
+        }
+    }
+
+    // In-flight table: at most one outstanding Papyrus call per key. Only keys that were dispatched or restored
+    // from a save have a state; PruneDispatchStates drops the ones that no longer hold anything back.
+    struct DispatchState {
+        std::chrono::steady_clock::time_point lastDispatch{};
+        std::shared_ptr<DynamicTranslationSE::CircuitBreaker> breaker{};  // of the script in flight
+        std::chrono::steady_clock::time_point refreshNotBefore{};           // staggers keys restored from a save
+        std::chrono::steady_clock::duration refreshInterval{};              // kInterval throttle of the last dispatch
+        bool inFlight{false};
+    };
+
+    struct FinishedDispatch {
+        std::chrono::steady_clock::time_point started;
+        std::shared_ptr<DynamicTranslationSE::CircuitBreaker> breaker;
+    };
+
+    struct DispatchCounters {
+        std::atomic<std::uint64_t> dispatched{0};
+        std::atomic<std::uint64_t> coalesced{0};
+        std::atomic<std::uint64_t> throttled{0};
+        std::atomic<std::uint64_t> capped{0};
+    };
+
+    std::mutex dispatchMutex;
+    std::unordered_map<std::string, DispatchState, StringHash, std::equal_to<>> dispatchStates;
+    std::uint32_t dispatchesInFlight = 0;
+    DispatchCounters dispatchCounters;
+
+    bool TryBeginDispatch(const DynamicTranslationSE::Provider& prov, const std::string_view a_key,
+                          const bool hasResult) {
+        using namespace DynamicTranslationFrameworkSE;
+        using DynamicTranslationSE::RefreshPolicy;
+
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard lk(dispatchMutex);
+        // Keys without a state behave like a default one; a state is only created for an actual dispatch, so keys
+        // that are throttled or capped do not grow the table
+        auto it = dispatchStates.find(a_key);
+        DispatchState unseen;
+        auto& state = it != dispatchStates.end() ? it->second : unseen;
+
+        if (state.inFlight) {
+            if (now - state.lastDispatch < kPapyrusDispatchTimeout) {
+                dispatchCounters.coalesced.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            spdlog::warn("Papyrus translation for key '{}' timed out, dispatching again", a_key);
+            state.inFlight = false;
+            --dispatchesInFlight;
+            if (state.breaker) {
+                state.breaker->Fail(fmt::format("did not answer key '{}' within {} ms", a_key,
+                                                kPapyrusDispatchTimeout.count()));
+            }
+        }
+
+        if (hasResult) {
+            if (now < state.refreshNotBefore || prov.refresh == RefreshPolicy::kEvent ||
+                (prov.refresh == RefreshPolicy::kInterval && now - state.lastDispatch < prov.refreshInterval)) {
+                dispatchCounters.throttled.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        if (dispatchesInFlight >= kMaxConcurrentPapyrusDispatches) {
+            dispatchCounters.capped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (prov.breaker && !prov.breaker->Allow()) {
+            return false;
+        }
+
+        if (it == dispatchStates.end()) {
+            it = dispatchStates.emplace(a_key, unseen).first;
+        }
+        auto& dispatched = it->second;
+        dispatched.inFlight = true;
+        dispatched.lastDispatch = now;
+        dispatched.breaker = prov.breaker;
+        dispatched.refreshInterval = prov.refresh == RefreshPolicy::kInterval ? prov.refreshInterval
+                                                                               : std::chrono::milliseconds::zero();
+        ++dispatchesInFlight;
+        dispatchCounters.dispatched.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Fixed part of every entry in a Papyrus result snapshot, followed by the UTF-8 key and value
+    struct SnapshotEntry {
+        std::uint32_t keySize;
+        std::uint32_t valueSize;
+        std::uint32_t ttlMs;  // remaining when saved, 0 = none
+    };
+
+    template <class T>
+    void AppendRaw(std::string& a_out, const T& a_value) {
+        a_out.append(reinterpret_cast<const char*>(std::addressof(a_value)), sizeof(T));
+    }
+
+    template <class T>
+    bool ReadRaw(std::string_view& a_in, T& a_value) {
+        if (a_in.size() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(std::addressof(a_value), a_in.data(), sizeof(T));
+        a_in.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    // Returns when the finished dispatch was started and who served it, if it was still tracked
+    std::optional<FinishedDispatch> EndDispatch(const std::string_view a_key) {
+        std::lock_guard lk(dispatchMutex);
+        if (const auto it = dispatchStates.find(a_key); it != dispatchStates.end() && it->second.inFlight) {
+            it->second.inFlight = false;
+            --dispatchesInFlight;
+            return FinishedDispatch{it->second.lastDispatch, std::move(it->second.breaker)};
+        }
+        return std::nullopt;
+    }
+}
+
+namespace DynamicTranslationSE {
+    void SetTranslationHost(TranslationHost* a_host) {
+        host = a_host;
+    }
+
+    std::wstring TranslateKey(const wchar_t* a_key, TranslateOutcome* a_outcome) {
+        if (!a_key || a_key[0] != L'$') {
+            return {};
+        }
+
+        // Fast path: registered keys resolve without transcoding, allocating or locking
+        const ProviderRegistry::ReadGuard registry;
+        if (const auto entry = registry->Find(a_key)) {
+            registry->CountHit(*entry);
+            const auto& prov = Bound(registry->ProviderOf(*entry));
+            if (a_outcome) {
+                *a_outcome = {KindOf(prov), true};
+            }
+            return InvokeProvider(prov, entry->key);
+        }
+
+        // Key families registered by prefix need the concrete key, so these do transcode
+        if (const auto entry = registry->FindPrefix(a_key)) {
+            registry->CountHit(*entry);
+            const auto& prov = Bound(registry->ProviderOf(*entry));
+            if (a_outcome) {
+                *a_outcome = {KindOf(prov), true};
+            }
+            const Text::Utf8Buffer key(a_key + 1);
+            return InvokeProvider(prov, key.view());
+        }
+
+        // Slow path: results pushed by scripts for keys without a config entry
+        if (!HasUnregisteredResults()) {
+            return {};
+        }
+        const Text::Utf8Buffer keyUtf8(a_key + 1);
+        if (keyUtf8.view().empty()) {
+            return {};
+        }
+        if (a_outcome) {
+            a_outcome->provider = ProviderKind::kUnregistered;
+        }
+        return InvokeProvider(Provider{}, keyUtf8.view());
+    }
+
+    std::wstring InvokeProvider(const Provider& prov, const std::string_view a_key) {
+        if (prov.lazy) {
+            return InvokeProvider(prov.lazy->Get(), a_key);
+        }
+        const Stats::ScopedProviderTimer timer(prov.statsId);
+        try {
+            if (prov.rules) {
+                if (auto text = prov.rules->Evaluate(); !text.empty()) {
+                    return text;
+                }
+                if (!prov.native && !prov.batch && prov.scriptID.second.empty()) {
+                    return {};
+                }
+            }
+            if (prov.native || prov.batch) {
+                if (!prov.memoize && !prov.batch && !prov.async) {
+                    // Nothing is cached for these, so a skipped call leaves the vanilla translation
+                    if (!AdmitCall(prov)) {
+                        return {};
+                    }
+                    return GuardedCall(prov, a_key, prov.budget, true, [&] { return CallNative(prov, a_key); })
+                        .value_or(std::wstring{});
+                }
+                // Read the generation before calling: when the key is invalidated during the call, the result is
+                // stored under a generation that lookups no longer match and the provider is asked again
+                const auto generation = NativeGeneration(prov, a_key);
+                std::wstring result;
+                if (!nativeResults.Get(a_key, result, generation)) {
+                    if (prov.async) {
+                        return InvokeAsync(prov, a_key, generation);
+                    }
+                    // A synchronous batch may answer pending; until the provider delivers, show what we had
+                    auto& pool = AsyncPool::GetSingleton();
+                    const bool busy = prov.batch && pool.IsBusy(a_key);
+                    if (prov.batch && !busy && prov.batch->Defer(a_key, prov)) {
+                        // The DLL was already called this frame; the key goes with the others at the end of it
+                        QueueBatchFlush(prov);
+                        nativeResults.GetLastKnown(a_key, result);
+                        return result;
+                    }
+                    if (busy || !AdmitCall(prov)) {
+                        nativeResults.GetLastKnown(a_key, result);
+                        return result;
+                    }
+                    if (prov.batch) {
+                        auto fetched = GuardedCall(prov, a_key, prov.budget, true, [&] {
+                            return prov.batch->Fetch(a_key, nativeResults, prov);
+                        });
+                        if (!fetched || pool.IsBusy(a_key)) {
+                            nativeResults.GetLastKnown(a_key, result);
+                        } else {
+                            result = std::move(*fetched);
+                        }
+                    } else if (auto called = GuardedCall(prov, a_key, prov.budget, true,
+                                                         [&] { return CallNative(prov, a_key); })) {
+                        result = std::move(*called);
+                        nativeResults.Put(a_key, result, prov.ttl, generation);
+                    } else {
+                        nativeResults.GetLastKnown(a_key, result);
+                    }
+                }
+                return result;
+            }
+            std::wstring result;
+            const bool hasResult = papyrusResults.Get(a_key, result);
+            if (host && !prov.scriptID.second.empty() && TryBeginDispatch(prov, a_key, hasResult)) {
+                host->DispatchPapyrus(prov.scriptID, std::string(a_key), prov.ttl);
+            }
+            return result;
+        } catch (const std::exception& e) {
+            spdlog::error("Provider '{}' failed for key '{}': {}", ProviderName(prov), a_key, e.what());
+        } catch (...) {
+            spdlog::error("Provider '{}' failed for key '{}'", ProviderName(prov), a_key);
+        }
+        return std::wstring{};
+    }
+
+    void CompletePapyrusDispatch(const std::string& a_key, const std::wstring_view a_result,
+                                 const std::chrono::milliseconds a_ttl) {
+        if (const auto finished = EndDispatch(a_key)) {
+            const auto roundTrip = Stats::Clock::now() - finished->started;
+            Stats::Record(Stats::Metric::kPapyrusRoundTrip, roundTrip);
+            if (finished->breaker) {
+                finished->breaker->Report(roundTrip, DynamicTranslationFrameworkSE::kPapyrusDispatchTimeout);
+            }
+        }
+        if (!a_result.empty()) {
+            papyrusResults.Put(a_key, a_result, a_ttl);
+        }
+    }
+
+    void CompleteNativeRequest(const std::string_view a_key, const wchar_t* a_result) {
+        const auto request = AsyncPool::GetSingleton().TakePending(a_key);
+        if (!request) {
+            return;
+        }
+        StoreNativeResult(a_key, a_result ? std::wstring_view(a_result) : std::wstring_view{}, request->ttl,
+                          request->generation);
+    }
+
+    void FlushNativeBatches() {
+        std::vector<Provider> batches;
+        {
+            std::lock_guard lk(deferredBatchMutex);
+            batches.swap(deferredBatches);
+        }
+        bool stored = false;
+        for (const auto& prov : batches) {
+            // Keys of an open breaker stay deferred until they are translated again
+            if (prov.breaker && !prov.breaker->Allow()) {
+                continue;
+            }
+            GuardedCall(prov, "(deferred keys)", prov.budget, false, [&] {
+                stored = prov.batch->FlushDeferred(nativeResults) || stored;
+                return std::wstring{};
+            });
+        }
+        if (stored && host) {
+            host->RequestRefresh();
+        }
+    }
+
+    void CancelAsyncRequests() {
+        AsyncPool::GetSingleton().CancelAll();
+    }
+
+    std::string SavePapyrusResults() {
+        std::string out;
+        std::uint32_t count = 0;
+        AppendRaw(out, count);
+        papyrusResults.ForEach([&](const std::string_view a_key, const std::wstring_view a_value,
+                                   const ResultCache::Clock::duration a_remaining) {
+            const Text::Utf8Buffer value(a_value);
+            // A TTL about to run out is rounded up so the entry is not saved as one that never expires
+            const auto ttlMs = a_remaining == ResultCache::Clock::duration::zero()
+                                   ? 0
+                                   : std::max<std::int64_t>(
+                                         std::chrono::duration_cast<std::chrono::milliseconds>(a_remaining).count(), 1);
+            AppendRaw(out, SnapshotEntry{static_cast<std::uint32_t>(a_key.size()),
+                                         static_cast<std::uint32_t>(value.view().size()),
+                                         static_cast<std::uint32_t>(std::min<std::int64_t>(ttlMs, UINT32_MAX))});
+            out.append(a_key);
+            out.append(value.view());
+            ++count;
+        });
+        std::memcpy(out.data(), &count, sizeof(count));
+        return out;
+    }
+
+    bool LoadPapyrusResults(std::string_view a_data, const std::uint32_t a_version) {
+        using namespace DynamicTranslationFrameworkSE;
+        ClearPapyrusResults();
+        if (a_version != kPapyrusResultsVersion) {
+            spdlog::warn("Papyrus result snapshot has version {}, expected {}; starting empty", a_version,
+                         kPapyrusResultsVersion);
+            return false;
+        }
+
+        try {
+            std::uint32_t count = 0;
+            if (!ReadRaw(a_data, count)) {
+                return false;
+            }
+
+            struct Restored {
+                std::string key;
+                std::wstring value;
+                std::chrono::milliseconds ttl;
+            };
+            std::vector<Restored> restored;
+            // The count comes from the save, so it only sizes the vector as far as the data could back it
+            restored.reserve(std::min<std::size_t>(count, a_data.size() / sizeof(SnapshotEntry)));
+            for (std::uint32_t i = 0; i < count; ++i) {
+                SnapshotEntry entry{};
+                if (!ReadRaw(a_data, entry) || a_data.size() < std::size_t{entry.keySize} + entry.valueSize) {
+                    spdlog::warn("Papyrus result snapshot is truncated after {} of {} entries; starting empty", i,
+                                 count);
+                    return false;
+                }
+                restored.push_back({std::string(a_data.substr(0, entry.keySize)),
+                                    Text::Utf8ToWide(a_data.substr(entry.keySize, entry.valueSize)),
+                                    std::chrono::milliseconds(entry.ttlMs)});
+                a_data.remove_prefix(entry.keySize + entry.valueSize);
+            }
+
+            bool unregistered = false;
+            {
+                const ProviderRegistry::ReadGuard registry;
+                for (const auto& entry : restored) {
+                    unregistered = unregistered || !registry->Find(entry.key);
+                }
+            }
+            if (unregistered) {
+                hasUnregisteredResults.store(true, std::memory_order_relaxed);
+            }
+
+            // The scripts are still asked for fresh text, but a few keys at a time rather than all on the first frame
+            const auto now = std::chrono::steady_clock::now();
+            const auto step = kRestoredRefreshSpread / std::max<std::size_t>(restored.size(), 1);
+            {
+                std::lock_guard lk(dispatchMutex);
+                for (std::size_t i = 0; i < restored.size(); ++i) {
+                    dispatchStates[restored[i].key].refreshNotBefore =
+                        now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(step * i);
+                }
+            }
+            for (auto& entry : restored) {
+                papyrusResults.Put(entry.key, entry.value, entry.ttl);
+            }
+            spdlog::info("Restored {} Papyrus results from the save", restored.size());
+            return true;
+        } catch (const std::exception& e) {
+            spdlog::warn("Failed to restore Papyrus results from the save: {}; starting empty", e.what());
+            ClearPapyrusResults();
+            return false;
+        }
+    }
+
+    void ClearPapyrusResults() {
+        papyrusResults.Clear();
+        // Calls still running in the VM belong to the session being left; their keys may be dispatched again.
+        // They never complete here, so each is written off with its breaker, which may be waiting on it as a probe.
+        std::lock_guard lk(dispatchMutex);
+        std::vector<std::shared_ptr<CircuitBreaker>> abandoned;
+        for (const auto& [key, state] : dispatchStates) {
+            if (state.inFlight && state.breaker && std::ranges::find(abandoned, state.breaker) == abandoned.end()) {
+                abandoned.push_back(state.breaker);
+            }
+        }
+        for (const auto& breaker : abandoned) {
+            breaker->Fail("had a call in flight when the game was loaded");
+        }
+        dispatchStates.clear();
+        dispatchesInFlight = 0;
+    }
+
+    void PruneDispatchStates() {
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard lk(dispatchMutex);
+        const auto pruned = std::erase_if(dispatchStates, [&](const auto& a_entry) {
+            const auto& state = a_entry.second;
+            return !state.inFlight && now >= state.refreshNotBefore &&
+                   now - state.lastDispatch >= state.refreshInterval;
+        });
+        if (pruned) {
+            spdlog::debug("Pruned {} idle Papyrus dispatch states, {} left", pruned, dispatchStates.size());
+        }
+    }
+
+    void PushResult(const std::string_view a_key, const std::string_view a_valueUtf8) {
+        std::chrono::milliseconds ttl{};
+        {
+            const ProviderRegistry::ReadGuard registry;
+            if (const auto entry = registry->Find(a_key)) {
+                ttl = registry->ProviderOf(*entry).ttl;
+            } else {
+                hasUnregisteredResults.store(true, std::memory_order_relaxed);
+            }
+        }
+        const Text::WideBuffer value(a_valueUtf8);
+        papyrusResults.Put(a_key, value.view(), ttl);
+    }
+
+    std::uint64_t CurrentFrame() {
+        return host ? host->CurrentFrame() : 0;
+    }
+
+    std::uint64_t NativeResultGeneration(const std::string_view a_key, const bool a_memoize,
+                                         const DynamicTranslationGenerationFunc a_providerGeneration) {
+        constexpr std::uint64_t kMix = 0x9E3779B97F4A7C15ull;
+        auto generation = nativeGeneration.load(std::memory_order_acquire);
+        if (hasKeyStamps.load(std::memory_order_acquire)) {
+            std::shared_lock lock(keyStampMutex);
+            if (const auto it = keyStamps.find(a_key); it != keyStamps.end()) {
+                generation = generation * kMix + it->second;
+            }
+        }
+        if (a_providerGeneration) {
+            generation = generation * kMix + a_providerGeneration();
+        }
+        // Results that are not memoized are only reused within the frame they were fetched in
+        if (!a_memoize) {
+            generation = generation * kMix + CurrentFrame();
+        }
+        return generation;
+    }
+
+    bool HasUnregisteredResults() {
+        return hasUnregisteredResults.load(std::memory_order_relaxed);
+    }
+
+    void InvalidateKey(const std::string_view a_key) {
+        {
+            std::unique_lock lock(keyStampMutex);
+            if (const auto it = keyStamps.find(a_key); it != keyStamps.end()) {
+                ++it->second;
+            } else {
+                keyStamps.emplace(a_key, 1);
+            }
+            hasKeyStamps.store(true, std::memory_order_release);
+        }
+        nativeResults.Erase(a_key);
+    }
+
+    void InvalidateAll() {
+        // The new generation already outdates every stamped result, so the stamps can start over
+        nativeGeneration.fetch_add(1, std::memory_order_acq_rel);
+        std::unique_lock lock(keyStampMutex);
+        keyStamps.clear();
+        hasKeyStamps.store(false, std::memory_order_release);
+    }
+
+    void LogStats() {
+        static std::uint64_t lastTotal = 0;
+        const auto dispatched = dispatchCounters.dispatched.load(std::memory_order_relaxed);
+        const auto coalesced = dispatchCounters.coalesced.load(std::memory_order_relaxed);
+        const auto throttled = dispatchCounters.throttled.load(std::memory_order_relaxed);
+        const auto capped = dispatchCounters.capped.load(std::memory_order_relaxed);
+        const auto cache = papyrusResults.GetStats();
+        const auto memo = nativeResults.GetStats();
+        const auto async = AsyncPool::GetSingleton().GetCounters();
+        const auto deferred = deferredCalls.load(std::memory_order_relaxed);
+        if (const auto total = dispatched + coalesced + throttled + capped + cache.hits + cache.misses + memo.hits +
+                               memo.misses + async.submitted + async.rejected + deferred;
+            total != lastTotal) {
+            lastTotal = total;
+            spdlog::info("Papyrus dispatches: {} sent, {} coalesced, {} throttled, {} capped", dispatched, coalesced,
+                         throttled, capped);
+            if (deferred) {
+                spdlog::info("Provider calls deferred by the frame budget: {}", deferred);
+            }
+            if (async.submitted || async.rejected) {
+                spdlog::info("Async provider calls: {} submitted, {} completed, {} rejected, {} cancelled",
+                             async.submitted, async.completed, async.rejected, async.cancelled);
+            }
+            papyrusResults.LogStats("Papyrus result");
+            nativeResults.LogStats("Native memo");
+        }
+    }
+}
@@ -1,25 +1,11 @@
 #include "DynamicTranslationSE.h"
+#include "Core/Stats.h"
+#include "Core/Text.h"
+#include "Core/Trace.h"
 #include "PapyrusWrapper.h"
 #include "Utils.h"
 
 namespace {
-    std::shared_mutex papyrusResultsMutex;
-    inline std::unordered_map<std::string, std::string> papyrusResults;
-
-
-    std::wstring Utf8ToWide(const char* utf8) {
-        if (!utf8 || *utf8 == '\0') {
-            return {};
-        }
-        const int required = MultiByteToWideChar(CP_UTF8, 0, utf8, -1, nullptr, 0);
-        if (required <= 0) {
-            return {};
-        }
-        std::wstring wide(static_cast<std::size_t>(required - 1), L'\0');
-        MultiByteToWideChar(CP_UTF8, 0, utf8, -1, wide.data(), required);
-        return wide;
-    }
-
     RE::GFxTranslator* GetTranslator() {
         const auto scaleformManager = RE::BSScaleformManager::GetSingleton();
         const auto loader = scaleformManager ? scaleformManager->loader : nullptr;
@@ -41,60 +27,218 @@ namespace {
     }
 
     Utils::FireAndForget RunPapyrusTranslationAsync(const std::string keyUtf8,
-                                                    const DynamicTranslationSE::PapyrusScriptID& scriptID) {
+                                                    const DynamicTranslationSE::PapyrusScriptID scriptID,
+                                                    const std::chrono::milliseconds ttl) {
         auto awaitable = PapyrusWrapper::GetSingleton()->GetDynamicTranslation(scriptID, keyUtf8);
 
         const RE::BSScript::Variable result = co_await awaitable;
 
         if (!result.IsString()) {
             logger::warn("RunPapyrusTranslationAsync: result for key '{}' is not a string", keyUtf8);
+            DynamicTranslationSE::CompletePapyrusDispatch(keyUtf8, {}, ttl);
+        } else {
+            const DynamicTranslationSE::Text::WideBuffer value(result.GetString());
+            DynamicTranslationSE::CompletePapyrusDispatch(keyUtf8, value.view(), ttl);
+        }
+        co_return;
+    }
 
+    struct PendingPapyrusKey {
+        std::string key;
+        std::chrono::milliseconds ttl;
+    };
+
+    // One event for every key a script was asked for during a UI frame. The script answers with a string[] parallel
+    // to the keys, or returns nothing and publishes later through DynamicTranslateBatchV1.
+    Utils::FireAndForget RunPapyrusBatchAsync(const DynamicTranslationSE::PapyrusScriptID scriptID,
+                                              const std::vector<PendingPapyrusKey> keys) {
+        std::vector<std::string> names;
+        names.reserve(keys.size());
+        for (const auto& pending : keys) {
+            names.push_back(pending.key);
+        }
+
+        auto awaitable = PapyrusWrapper::GetSingleton()->GetDynamicTranslationBatch(scriptID, names);
+        if (!awaitable) {
+            // Scripts that only implement the single-key event
+            for (const auto& pending : keys) {
+                RunPapyrusTranslationAsync(pending.key, scriptID, pending.ttl);
+            }
             co_return;
         }
 
-        if (const auto result_str = result.GetString(); !result_str.empty()) {
-            std::unique_lock lk(papyrusResultsMutex);
-            papyrusResults[keyUtf8] = result_str;
+        const RE::BSScript::Variable result = co_await *awaitable;
+
+        const auto values = result.IsArray() ? result.GetArray() : nullptr;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const bool hasValue = values && i < values->size() && (*values)[i].IsString();
+            const auto text = hasValue ? (*values)[i].GetString() : std::string_view{};
+            const DynamicTranslationSE::Text::WideBuffer value(text);
+            // Also called for keys without a value so they stop counting as in flight
+            DynamicTranslationSE::CompletePapyrusDispatch(keys[i].key, value.view(), keys[i].ttl);
         }
         co_return;
     }
 
+    class GameHost final : public DynamicTranslationSE::TranslationHost {
+    public:
+        // Advanced by a UI task queued on first use each frame, which also ends the frame for the batch providers
+        std::uint64_t CurrentFrame() override {
+            if (!uiFrameTickQueued.exchange(true, std::memory_order_acq_rel)) {
+                SKSE::GetTaskInterface()->AddUITask([this] {
+                    DynamicTranslationSE::FlushNativeBatches();
+                    uiFrame.fetch_add(1, std::memory_order_release);
+                    uiFrameTickQueued.store(false, std::memory_order_release);
+                });
+            }
+            return uiFrame.load(std::memory_order_acquire);
+        }
+
+        // Gathered per script and sent from a UI task, so a menu full of keys costs one call per script
+        void DispatchPapyrus(const DynamicTranslationSE::PapyrusScriptID& a_script, const std::string& a_key,
+                             const std::chrono::milliseconds a_ttl) override {
+            std::lock_guard lock(papyrusMutex);
+            papyrusBatches[a_script].push_back({a_key, a_ttl});
+            if (!papyrusFlushQueued) {
+                papyrusFlushQueued = true;
+                SKSE::GetTaskInterface()->AddUITask([this] { FlushPapyrusBatches(); });
+            }
+        }
+
+        // Asks every open menu to update, at most once per UI task round, so its text is translated again
+        void RequestRefresh() override {
+            if (refreshQueued.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            SKSE::GetTaskInterface()->AddUITask([this] {
+                refreshQueued.store(false, std::memory_order_release);
+                const auto ui = RE::UI::GetSingleton();
+                const auto messageQueue = RE::UIMessageQueue::GetSingleton();
+                if (!ui || !messageQueue) {
+                    return;
+                }
+                for (const auto& [name, entry] : ui->menuMap) {
+                    if (entry.menu && ui->IsMenuOpen(name)) {
+                        messageQueue->AddMessage(name, RE::UI_MESSAGE_TYPE::kUpdate, nullptr);
+                    }
+                }
+            });
+        }
+
+    private:
+        void FlushPapyrusBatches() {
+            std::map<DynamicTranslationSE::PapyrusScriptID, std::vector<PendingPapyrusKey>> batches;
+            {
+                std::lock_guard lock(papyrusMutex);
+                batches.swap(papyrusBatches);
+                papyrusFlushQueued = false;
+            }
+            using DynamicTranslationFrameworkSE::kMaxPapyrusBatchKeys;
+            for (auto& [script, keys] : batches) {
+                if (keys.size() == 1) {
+                    RunPapyrusTranslationAsync(keys.front().key, script, keys.front().ttl);
+                } else {
+                    for (std::size_t first = 0; first < keys.size(); first += kMaxPapyrusBatchKeys) {
+                        const auto last = std::min(first + kMaxPapyrusBatchKeys, keys.size());
+                        std::vector<PendingPapyrusKey> chunk(std::make_move_iterator(keys.begin() + first),
+                                                             std::make_move_iterator(keys.begin() + last));
+                        RunPapyrusBatchAsync(script, std::move(chunk));
+                    }
+                }
+            }
+        }
+
+        std::atomic<std::uint64_t> uiFrame{0};
+        std::atomic_bool uiFrameTickQueued{false};
+        std::atomic_bool refreshQueued{false};
+
+        std::mutex papyrusMutex;
+        std::map<DynamicTranslationSE::PapyrusScriptID, std::vector<PendingPapyrusKey>> papyrusBatches;
+        bool papyrusFlushQueued{false};
+    };
+
+    GameHost gameHost;
+
     // ReSharper disable once CppPassValueParameterByConstReference
     void DynamicTranslateV1(RE::StaticFunctionTag*, std::string a_key,
                             // ReSharper disable once CppPassValueParameterByConstReference
                             std::string a_val) { // NOLINT(performance-unnecessary-value-param)
-        std::unique_lock lk(papyrusResultsMutex);
-        papyrusResults[a_key] = a_val;
+        DynamicTranslationSE::PushResult(a_key, a_val);
+    }
+
+    // ReSharper disable once CppPassValueParameterByConstReference
+    void DynamicTranslateBatchV1(RE::StaticFunctionTag*, std::vector<std::string> a_keys,
+                                 // ReSharper disable once CppPassValueParameterByConstReference
+                                 std::vector<std::string> a_vals) { // NOLINT(performance-unnecessary-value-param)
+        if (a_keys.size() != a_vals.size()) {
+            logger::warn("DynamicTranslateBatchV1: {} keys but {} values, ignoring the extra ones", a_keys.size(),
+                         a_vals.size());
+        }
+        for (std::size_t i = 0; i < std::min(a_keys.size(), a_vals.size()); ++i) {
+            DynamicTranslationSE::PushResult(a_keys[i], a_vals[i]);
+        }
+    }
+
+    // ReSharper disable once CppPassValueParameterByConstReference
+    void InvalidateDynamicTranslationV1(RE::StaticFunctionTag*,
+                                        std::string a_key) { // NOLINT(performance-unnecessary-value-param)
+        DynamicTranslationSE::InvalidateKey(a_key);
+    }
+
+    void InvalidateAllDynamicTranslationsV1(RE::StaticFunctionTag*) {
+        DynamicTranslationSE::InvalidateAll();
+    }
+
+    std::string GetDynamicTranslationStatsV1(RE::StaticFunctionTag*) {
+        return DynamicTranslationSE::Stats::Report();
+    }
+
+    bool StartTranslationTraceV1(RE::StaticFunctionTag*) {
+        using namespace DynamicTranslationFrameworkSE;
+        const auto logsFolder = SKSE::log::log_directory();
+        return logsFolder && DynamicTranslationSE::Trace::Start(*logsFolder / kTraceFileName);
+    }
+
+    void StopTranslationTraceV1(RE::StaticFunctionTag*) {
+        DynamicTranslationSE::Trace::Stop();
     }
 }
 
 
 namespace DynamicTranslationSE {
-    std::wstring InvokeProvider(const Provider& prov, const std::string& a_key) {
-        try {
-            if (prov.native) {
-                const auto sv = prov.native(a_key);
-                const std::wstring result(sv);
-                return result;
-            }
-            if (!prov.scriptID.second.empty()) {
-                RunPapyrusTranslationAsync(a_key, prov.scriptID);
-            }
-            {
-                std::shared_lock lk(papyrusResultsMutex);
-                if (const auto it = papyrusResults.find(a_key); it != papyrusResults.end()) {
-                    std::wstring result = Utf8ToWide(it->second.c_str());
-                    return result;
-                }
-            }
-        } catch (...) {
-            logger::error("DynamicTranslationFrameworkSE: provider invoke failed");
-        }
-        return std::wstring{};
+    void InstallGameHost() {
+        SetTranslationHost(&gameHost);
     }
 
     bool InstallBindings(RE::BSScript::IVirtualMachine* vm) {
         vm->RegisterFunction("DynamicTranslateV1", "DynamicTranslationFramework", DynamicTranslateV1);
+        vm->RegisterFunction("DynamicTranslateBatchV1", "DynamicTranslationFramework", DynamicTranslateBatchV1);
+        vm->RegisterFunction("InvalidateDynamicTranslationV1", "DynamicTranslationFramework",
+                             InvalidateDynamicTranslationV1);
+        vm->RegisterFunction("InvalidateAllDynamicTranslationsV1", "DynamicTranslationFramework",
+                             InvalidateAllDynamicTranslationsV1);
+        vm->RegisterFunction("GetDynamicTranslationStatsV1", "DynamicTranslationFramework",
+                             GetDynamicTranslationStatsV1);
+        vm->RegisterFunction("StartTranslationTraceV1", "DynamicTranslationFramework", StartTranslationTraceV1);
+        vm->RegisterFunction("StopTranslationTraceV1", "DynamicTranslationFramework", StopTranslationTraceV1);
         return true;
     }
+}
+
+extern "C" {
+    __declspec(dllexport) void __cdecl DynamicTranslationInvalidateKey(const char* a_key) {
+        if (a_key) {
+            DynamicTranslationSE::InvalidateKey(a_key);
+        }
+    }
+
+    __declspec(dllexport) void __cdecl DynamicTranslationInvalidateAll() {
+        DynamicTranslationSE::InvalidateAll();
+    }
+
+    __declspec(dllexport) void __cdecl DynamicTranslationCompleteRequest(const char* a_key, const wchar_t* a_result) {
+        if (a_key) {
+            DynamicTranslationSE::CompleteNativeRequest(a_key, a_result);
+        }
+    }
 }
\ No newline at end of file
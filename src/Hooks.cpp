@@ -1,32 +1,60 @@
 #include "Hooks.h"
+#include "ConfigLoader.h"
 #include "DynamicTranslationSE.h"
-#include "Utils.h"
+#include "Core/Stats.h"
+#include "Core/Trace.h"
+#include "PapyrusWrapper.h"
+#include "Settings.h"
 
 bool Hooks::Install() {
+    if (const auto ui = RE::UI::GetSingleton()) {
+        ui->AddEventSink<RE::MenuOpenCloseEvent>(MenuEventSink::GetSingleton());
+    }
     return InstallTranslatorVtableHook();
 }
 
-void Hooks::Translate_Hook(RE::GFxTranslator* a_this, RE::GFxTranslator::TranslateInfo* a_info) {
-    auto keyUtf8 = Utils::WideToUtf8(a_info->GetKey());
+RE::BSEventNotifyControl Hooks::MenuEventSink::ProcessEvent(const RE::MenuOpenCloseEvent* a_event,
+                                                            RE::BSTEventSource<RE::MenuOpenCloseEvent>*) {
+    if (a_event && a_event->opening && a_event->menuName == RE::MainMenu::MENU_NAME) {
+        if (DynamicTranslationFrameworkSE::kPrewarmProviderDLLs) {
+            DynamicTranslationSE::ConfigLoader::Prewarm();
+        }
+    }
+    if (a_event && !a_event->opening) {
+        // Nothing on screen waits for async results the closed menu asked for
+        DynamicTranslationSE::CancelAsyncRequests();
+        DynamicTranslationSE::PruneDispatchStates();
+        DynamicTranslationSE::LogStats();
+        PapyrusWrapper::GetSingleton()->LogStats();
+        if (const auto logsFolder = SKSE::log::log_directory()) {
+            DynamicTranslationSE::Stats::MaybeDump(*logsFolder / DynamicTranslationFrameworkSE::kStatsFileName);
+        }
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
 
-    // Call original first
-    g_OrigTranslateAny(a_this, a_info);
+void Hooks::Translate_Hook(RE::GFxTranslator* a_this, RE::GFxTranslator::TranslateInfo* a_info) {
+    using namespace DynamicTranslationSE;
+    const Stats::ScopedTimer hookTimer(Stats::Metric::kHook);
+    const auto start = Stats::Clock::now();
 
-    if (keyUtf8.empty() || keyUtf8[0] != '$') return;
-    keyUtf8 = keyUtf8.substr(1);
+    const auto key = a_info->GetKey();
 
-    // Lookup provider by key
-    DynamicTranslationSE::Provider prov{};
+    // Call original first
     {
-        std::shared_lock lk(DynamicTranslationSE::gProvMutex);
-        if (const auto it = DynamicTranslationSE::gProvidersByKey.find(keyUtf8);
-            it != DynamicTranslationSE::gProvidersByKey.end()) {
-            prov = it->second;
-        }
+        const Stats::ScopedTimer originalTimer(Stats::Metric::kOriginalTranslate);
+        g_OrigTranslateAny(a_this, a_info);
     }
 
-    const auto body = InvokeProvider(prov, keyUtf8);
+    TranslateOutcome outcome;
+    const auto body = TranslateKey(key, &outcome);
     if (!body.empty()) a_info->SetResult(body.c_str(), body.size());
+
+    if (Trace::IsRecording()) {
+        const auto flags = static_cast<std::uint8_t>((outcome.registryHit ? Trace::kRegistryHit : 0) |
+                                                     (!body.empty() ? Trace::kTranslated : 0));
+        Trace::Record(key, outcome.provider, flags, Stats::Clock::now() - start);
+    }
 }
 
 bool Hooks::InstallTranslatorVtableHook() {
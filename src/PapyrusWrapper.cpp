@@ -1 +1,129 @@
-#include "PapyrusWrapper.h"
\ No newline at end of file
+#include "PapyrusWrapper.h"
+#include "Core/Stats.h"
+
+void PapyrusWrapper::Install() {
+    if (const auto holder = RE::ScriptEventSourceHolder::GetSingleton()) {
+        holder->AddEventSink<RE::TESFormDeleteEvent>(this);
+    }
+}
+
+PapyrusWrapper::Awaitable PapyrusWrapper::GetDynamicTranslation(const DynamicTranslationSE::PapyrusScriptID& scriptID,
+                                                                const std::string& a_key) {
+    if (const auto script = Resolve(scriptID)) {
+        if (const auto vm = Papyrus::VM::GetSingleton()) {
+            using namespace DynamicTranslationFrameworkSE;
+            const auto vmargs = RE::MakeFunctionArguments(static_cast<std::string>(a_key));
+            auto a_awaitable = vm->ADispatchMethodCall(script->object, api_function_name, vmargs);
+            delete vmargs;
+            logger::trace("GetDynamicTranslation: dispatched method call to script '{}'", scriptID.second);
+            return a_awaitable;
+        }
+    }
+    return {};
+}
+
+std::optional<PapyrusWrapper::Awaitable> PapyrusWrapper::GetDynamicTranslationBatch(
+    const DynamicTranslationSE::PapyrusScriptID& scriptID, const std::vector<std::string>& a_keys) {
+    const auto script = Resolve(scriptID);
+    if (!script || !script->hasBatch) {
+        return std::nullopt;
+    }
+    if (const auto vm = Papyrus::VM::GetSingleton()) {
+        using namespace DynamicTranslationFrameworkSE;
+        const auto vmargs = RE::MakeFunctionArguments(std::vector<std::string>(a_keys));
+        auto a_awaitable = vm->ADispatchMethodCall(script->object, api_batch_function_name, vmargs);
+        delete vmargs;
+        logger::trace("GetDynamicTranslationBatch: dispatched {} keys to script '{}'", a_keys.size(), scriptID.second);
+        return a_awaitable;
+    }
+    return std::nullopt;
+}
+
+std::optional<PapyrusWrapper::CachedScript> PapyrusWrapper::Resolve(
+    const DynamicTranslationSE::PapyrusScriptID& scriptID) {
+    {
+        std::lock_guard lock(mutex);
+        if (const auto it = scripts.find(scriptID); it != scripts.end()) {
+            if (it->second.object && it->second.object->IsValid()) {
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second;
+            }
+            // Detached since it was cached
+            scripts.erase(it);
+            invalidations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+
+    const auto a_form = RE::TESForm::LookupByID(scriptID.first);
+    const auto vm = Papyrus::VM::GetSingleton();
+    if (!a_form || !vm) {
+        return std::nullopt;
+    }
+
+    CachedScript script;
+    {
+        namespace Stats = DynamicTranslationSE::Stats;
+        // Contention on the VM's lock is reported apart from the lookup itself
+        const auto waitStart = Stats::Clock::now();
+        auto lock = RE::BSSpinLockGuard(vm->attachedScriptsLock);
+        Stats::Record(Stats::Metric::kScriptLockWait, Stats::Clock::now() - waitStart);
+        const Stats::ScopedTimer lookupTimer(Stats::Metric::kScriptLookup);
+        if (const auto a_script = Papyrus::GetAttachedScript(scriptID.second, a_form)) {
+            script.object = static_cast<RE::BSTSmartPointer<RE::BSScript::Object>>(a_script->get());
+        }
+    }
+    if (!script.object) {
+        return std::nullopt;
+    }
+    script.hasBatch = HasMethod(*script.object, DynamicTranslationFrameworkSE::api_batch_function_name);
+
+    std::lock_guard lock(mutex);
+    scripts.insert_or_assign(scriptID, script);
+    return script;
+}
+
+bool PapyrusWrapper::HasMethod(RE::BSScript::Object& a_object, const RE::BSFixedString& a_name) {
+    for (auto type = a_object.GetTypeInfo(); type; type = type->GetParent()) {
+        const auto funcs = type->GetMemberFuncIter();
+        for (std::uint32_t i = 0; i < type->GetNumMemberFuncs(); ++i) {
+            if (const auto& func = funcs[i].func; func && func->GetName() == a_name) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PapyrusWrapper::InvalidateScripts() {
+    std::lock_guard lock(mutex);
+    invalidations.fetch_add(scripts.size(), std::memory_order_relaxed);
+    scripts.clear();
+}
+
+PapyrusWrapper::Counters PapyrusWrapper::GetCounters() const {
+    return {hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed),
+            invalidations.load(std::memory_order_relaxed)};
+}
+
+void PapyrusWrapper::LogStats() const {
+    static std::uint64_t lastTotal = 0;
+    const auto counters = GetCounters();
+    if (const auto total = counters.hits + counters.misses; total != lastTotal) {
+        lastTotal = total;
+        logger::info("Papyrus script objects: {} cached, {} looked up, {} invalidated", counters.hits,
+                     counters.misses, counters.invalidations);
+    }
+}
+
+RE::BSEventNotifyControl PapyrusWrapper::ProcessEvent(const RE::TESFormDeleteEvent* a_event,
+                                                      RE::BSTEventSource<RE::TESFormDeleteEvent>*) {
+    if (a_event) {
+        std::lock_guard lock(mutex);
+        invalidations.fetch_add(std::erase_if(scripts, [&](const auto& a_entry) {
+                                    return a_entry.first.first == a_event->formID;
+                                }),
+                                std::memory_order_relaxed);
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
@@ -0,0 +1,50 @@
+#include "RuleOperands.h"
+
+namespace {
+    float ReadGlobal(const void* a_global, std::uint32_t) {
+        return static_cast<const RE::TESGlobal*>(a_global)->value;
+    }
+
+    float ReadQuestStage(const void* a_quest, std::uint32_t) {
+        return static_cast<float>(static_cast<const RE::TESQuest*>(a_quest)->GetCurrentStageID());
+    }
+
+    float ReadActorValue(const void*, const std::uint32_t a_actorValue) {
+        const auto player = RE::PlayerCharacter::GetSingleton();
+        return player ? player->AsActorValueOwner()->GetActorValue(static_cast<RE::ActorValue>(a_actorValue)) : 0.0f;
+    }
+
+    float ReadBaseActorValue(const void*, const std::uint32_t a_actorValue) {
+        const auto player = RE::PlayerCharacter::GetSingleton();
+        return player ? player->AsActorValueOwner()->GetBaseActorValue(static_cast<RE::ActorValue>(a_actorValue))
+                      : 0.0f;
+    }
+}
+
+namespace DynamicTranslationSE::RuleOperands {
+    std::optional<Rules::Operand> Resolve(const std::string_view a_kind, const std::string_view a_name) {
+        const std::string name(a_name);
+        if (a_kind == "global") {
+            if (const auto global = RE::TESForm::LookupByEditorID<RE::TESGlobal>(name)) {
+                return Rules::Operand{ReadGlobal, global};
+            }
+            logger::warn("RuleOperands: Global '{}' not found", name);
+        } else if (a_kind == "quest") {
+            if (const auto quest = RE::TESForm::LookupByEditorID<RE::TESQuest>(name)) {
+                return Rules::Operand{ReadQuestStage, quest};
+            }
+            logger::warn("RuleOperands: Quest '{}' not found", name);
+        } else if (a_kind == "av" || a_kind == "avbase") {
+            const auto list = RE::ActorValueList::GetSingleton();
+            const auto actorValue = list ? list->LookupActorValueByName(name) : RE::ActorValue::kNone;
+            if (actorValue != RE::ActorValue::kNone) {
+                return Rules::Operand{a_kind == "av" ? ReadActorValue : ReadBaseActorValue, nullptr,
+                                      static_cast<std::uint32_t>(actorValue)};
+            }
+            logger::warn("RuleOperands: Actor value '{}' not found", name);
+        } else {
+            logger::warn("RuleOperands: Unknown operand kind '{}'", a_kind);
+        }
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,47 @@
+#include "Serialization.h"
+#include "Core/Translator.h"
+
+namespace {
+    constexpr std::uint32_t kUniqueID = 'DTFS';
+    constexpr std::uint32_t kPapyrusResultsRecord = 'PRES';
+
+    void OnSave(SKSE::SerializationInterface* a_intfc) {
+        const auto snapshot = DynamicTranslationSE::SavePapyrusResults();
+        if (!a_intfc->OpenRecord(kPapyrusResultsRecord, DynamicTranslationSE::kPapyrusResultsVersion) ||
+            !a_intfc->WriteRecordData(snapshot.data(), static_cast<std::uint32_t>(snapshot.size()))) {
+            logger::error("Serialization: Failed to save {} bytes of Papyrus results", snapshot.size());
+        }
+    }
+
+    void OnLoad(SKSE::SerializationInterface* a_intfc) {
+        std::uint32_t type, version, length;
+        while (a_intfc->GetNextRecordInfo(type, version, length)) {
+            if (type != kPapyrusResultsRecord) {
+                logger::warn("Serialization: Skipping unknown record type {:08X}", type);
+                continue;
+            }
+            std::string snapshot(length, '\0');
+            if (a_intfc->ReadRecordData(snapshot.data(), length) != length) {
+                logger::error("Serialization: Papyrus result record is shorter than its {} bytes", length);
+                DynamicTranslationSE::ClearPapyrusResults();
+                continue;
+            }
+            DynamicTranslationSE::LoadPapyrusResults(snapshot, version);
+        }
+    }
+
+    // Runs before a save is loaded and when a new game starts
+    void OnRevert(SKSE::SerializationInterface*) {
+        DynamicTranslationSE::ClearPapyrusResults();
+    }
+}
+
+namespace DynamicTranslationSE::Serialization {
+    void Install() {
+        const auto serialization = SKSE::GetSerializationInterface();
+        serialization->SetUniqueID(kUniqueID);
+        serialization->SetSaveCallback(OnSave);
+        serialization->SetLoadCallback(OnLoad);
+        serialization->SetRevertCallback(OnRevert);
+    }
+}
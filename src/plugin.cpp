@@ -1,17 +1,30 @@
 #include "Hooks.h"
 #include "ConfigLoader.h"
 #include "logger.h"
+#include "PapyrusWrapper.h"
+#include "Serialization.h"
 
 namespace {
     // ReSharper disable once CppParameterMayBeConstPtrOrRef
     void OnMessage(SKSE::MessagingInterface::Message* message) {
         if (message->type == SKSE::MessagingInterface::kDataLoaded) {
+            const auto start = std::chrono::steady_clock::now();
             if (!SKSE::GetPapyrusInterface()->Register(DynamicTranslationSE::InstallBindings)) {
                 logger::error("Failed to register Papyrus API");
                 return;
             }
+            DynamicTranslationSE::InstallGameHost();
+            PapyrusWrapper::GetSingleton()->Install();
             DynamicTranslationSE::ConfigLoader::Load();
             Hooks::Install();
+            const auto elapsed =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            logger::info("DataLoaded handled in {:.2f} ms", elapsed.count() / 1000.0);
+        } else if (message->type == SKSE::MessagingInterface::kPreLoadGame ||
+                   message->type == SKSE::MessagingInterface::kPostLoadGame ||
+                   message->type == SKSE::MessagingInterface::kNewGame) {
+            // Script objects of the previous session are gone
+            PapyrusWrapper::GetSingleton()->InvalidateScripts();
         }
     }
 }
@@ -21,5 +34,6 @@ SKSEPluginLoad(const SKSE::LoadInterface *skse) {
     logger::info("Plugin loaded");
     SKSE::Init(skse);
     SKSE::GetMessagingInterface()->RegisterListener(OnMessage);
+    DynamicTranslationSE::Serialization::Install();
     return true;
 }
\ No newline at end of file